@@ -0,0 +1,328 @@
+#include <benchmark/benchmark.h>
+
+#include "cef_aggregator.hpp"
+#include "cef_archive.hpp"
+#include "cef_event.hpp"
+#include "cef_event_batch.hpp"
+#include "cef_event_columns.hpp"
+#include "cef_filter.hpp"
+#include "cef_parser.hpp"
+#include "corpus.hpp"
+
+#include <map>
+#include <sstream>
+
+using namespace cef_cpp;
+using namespace cef_cpp::bench;
+
+namespace {
+
+constexpr size_t corpus_size = 4096;
+constexpr size_t batch_size = 1000;
+
+const std::vector<std::string>& cachedCorpus(const Corpus corpus) {
+    static std::map<Corpus, std::vector<std::string>> corpora;
+    auto it = corpora.find(corpus);
+    if (it == corpora.end()) {
+        it = corpora.emplace(corpus, generateCorpus(corpus, corpus_size)).first;
+    }
+    return it->second;
+}
+
+Corpus corpusArg(benchmark::State& state) {
+    const auto corpus = static_cast<Corpus>(state.range(0));
+    state.SetLabel(corpusName(corpus));
+    return corpus;
+}
+
+void reportThroughput(benchmark::State& state, const size_t events, const size_t bytes) {
+    state.SetItemsProcessed(static_cast<int64_t>(events));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+void allCorpora(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgName("corpus");
+    for (const auto corpus : {Corpus::Short, Corpus::Wide, Corpus::EscapeHeavy, Corpus::Mixed}) {
+        benchmark->Arg(static_cast<int64_t>(corpus));
+    }
+}
+
+void BM_Parse(benchmark::State& state) {
+    const auto& lines = cachedCorpus(corpusArg(state));
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Parser::parse(lines[i]));
+        bytes += lines[i].size();
+        i = (i + 1) % lines.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_Parse)->Apply(allCorpora);
+
+void BM_ParseInto(benchmark::State& state) {
+    const auto& lines = cachedCorpus(corpusArg(state));
+    Parser parser;
+    Event event;
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.parseInto(lines[i], event));
+        bytes += lines[i].size();
+        i = (i + 1) % lines.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_ParseInto)->Apply(allCorpora);
+
+void BM_ParseView(benchmark::State& state) {
+    const auto& lines = cachedCorpus(corpusArg(state));
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Parser::parseView(lines[i]));
+        bytes += lines[i].size();
+        i = (i + 1) % lines.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_ParseView)->Apply(allCorpora);
+
+// Typical consumer: parse, then read a handful of extensions
+void BM_ParseAndLookup(benchmark::State& state) {
+    const auto& lines = cachedCorpus(corpusArg(state));
+    ParseOptions options;
+    options.lazy_extensions = state.range(1) != 0;
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        const auto event = Parser::parse(lines[i], options);
+        benchmark::DoNotOptimize(event.getSourceAddress());
+        benchmark::DoNotOptimize(event.getDestinationAddress());
+        benchmark::DoNotOptimize(event.getSourcePort());
+        benchmark::DoNotOptimize(event.getExtension("act"));
+        bytes += lines[i].size();
+        i = (i + 1) % lines.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_ParseAndLookup)->ArgNames({"corpus", "lazy"})->ArgsProduct({{0, 1, 2, 3}, {0, 1}});
+
+void BM_IsValidCEF(benchmark::State& state) {
+    // One line in ten is junk, as seen from devices mixing banners into the feed
+    auto lines = cachedCorpus(corpusArg(state));
+    for (size_t i = 0; i < lines.size(); i += 10) {
+        lines[i] = "<13>Oct 16 10:00:00 host sshd[42]: session opened for user root";
+    }
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Parser::isValidCEF(lines[i]));
+        bytes += lines[i].size();
+        i = (i + 1) % lines.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_IsValidCEF)->Apply(allCorpora);
+
+void BM_ParseMultiple(benchmark::State& state) {
+    const auto& corpus = cachedCorpus(corpusArg(state));
+    const std::vector<std::string> lines(corpus.begin(), corpus.begin() + batch_size);
+    const size_t batch_bytes = corpusBytes(lines);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Parser::parseMultiple(lines));
+    }
+    reportThroughput(state, state.iterations() * lines.size(), state.iterations() * batch_bytes);
+}
+BENCHMARK(BM_ParseMultiple)->Apply(allCorpora);
+
+void BM_ParseBatch(benchmark::State& state) {
+    const auto& corpus = cachedCorpus(corpusArg(state));
+    const std::vector<std::string> lines(corpus.begin(), corpus.begin() + batch_size);
+    const size_t batch_bytes = corpusBytes(lines);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Parser::parseBatch(lines));
+    }
+    reportThroughput(state, state.iterations() * lines.size(), state.iterations() * batch_bytes);
+}
+BENCHMARK(BM_ParseBatch)->Apply(allCorpora);
+
+void BM_ParseColumns(benchmark::State& state) {
+    const auto& corpus = cachedCorpus(corpusArg(state));
+    const std::vector<std::string> lines(corpus.begin(), corpus.begin() + batch_size);
+    const size_t batch_bytes = corpusBytes(lines);
+    EventColumns columns({"src", "dst", "spt", "dpt", "act"});
+    for (auto _ : state) {
+        columns.clear();
+        for (const auto& line : lines) {
+            benchmark::DoNotOptimize(columns.tryAppend(line));
+        }
+    }
+    reportThroughput(state, state.iterations() * lines.size(), state.iterations() * batch_bytes);
+}
+BENCHMARK(BM_ParseColumns)->Apply(allCorpora);
+
+// Keep events with severity >= 2 and act != allowed, filtering after parsing (arg 0) or
+// during parsing (arg 1)
+void BM_ParseFiltered(benchmark::State& state) {
+    const auto& corpus = cachedCorpus(corpusArg(state));
+    const bool early = state.range(1) != 0;
+    const Filter filter("severity >= 2 and act != allowed");
+    ParseOptions options;
+    if (early) {
+        options.filter = std::make_shared<Filter>(filter);
+    }
+
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        const auto& line = corpus[i++ % corpus.size()];
+        auto event = Parser::tryParse(line, options);
+        if (event && (early || filter.matches(*event))) {
+            benchmark::DoNotOptimize(event);
+        }
+        bytes += line.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_ParseFiltered)->ArgNames({"corpus", "early"})->ArgsProduct({{0, 1, 2, 3}, {0, 1}});
+
+// Keep src, dst and rt only (arg 1) or everything (arg 0)
+void BM_ParseProjected(benchmark::State& state) {
+    const auto& corpus = cachedCorpus(corpusArg(state));
+    ParseOptions options;
+    if (state.range(1) != 0) {
+        options.projection = std::make_shared<Projection>(
+            std::vector<std::string>{"src", "dst", "rt"});
+    }
+
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        const auto& line = corpus[i++ % corpus.size()];
+        benchmark::DoNotOptimize(Parser::tryParse(line, options));
+        bytes += line.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_ParseProjected)->ArgNames({"corpus", "projected"})->ArgsProduct({{0, 1, 2, 3}, {0, 1}});
+
+void BM_ParseFromString(benchmark::State& state) {
+    const auto& corpus = cachedCorpus(corpusArg(state));
+    std::string log;
+    for (size_t i = 0; i < batch_size; ++i) {
+        log += corpus[i];
+        log += "\n";
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Parser::parseFromString(log));
+    }
+    reportThroughput(state, state.iterations() * batch_size, state.iterations() * log.size());
+}
+BENCHMARK(BM_ParseFromString)->Apply(allCorpora);
+
+void BM_EventToString(benchmark::State& state) {
+    const auto& lines = cachedCorpus(corpusArg(state));
+    const auto events = Parser::parseMultiple(lines);
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        const auto serialized = events[i].toString();
+        bytes += serialized.size();
+        benchmark::DoNotOptimize(serialized);
+        i = (i + 1) % events.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_EventToString)->Apply(allCorpora);
+
+// Reloading archived events, to compare with parsing their CEF lines again
+void BM_ArchiveRead(benchmark::State& state) {
+    const auto& corpus = cachedCorpus(corpusArg(state));
+    const auto events = Parser::parseMultiple(corpus);
+    std::ostringstream output;
+    {
+        ArchiveWriter writer(output);
+        writer.write(events);
+    }
+    const std::string archive = output.str();
+    for (auto _ : state) {
+        auto reader = ArchiveReader::fromBuffer(archive);
+        while (auto event = reader.next()) {
+            benchmark::DoNotOptimize(*event);
+        }
+    }
+    reportThroughput(state, state.iterations() * events.size(),
+                     state.iterations() * archive.size());
+}
+BENCHMARK(BM_ArchiveRead)->Apply(allCorpora);
+
+// Merging parsed events into windows keyed on the default header fields
+void BM_Aggregate(benchmark::State& state) {
+    const auto& corpus = cachedCorpus(corpusArg(state));
+    const auto events = Parser::parseMultiple(corpus);
+    size_t summaries = 0;
+    Aggregator aggregator([&](Event&&) { ++summaries; });
+    const Timestamp now(std::chrono::milliseconds(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        aggregator.add(events[i], now);
+        i = (i + 1) % events.size();
+    }
+    aggregator.flushAll();
+    benchmark::DoNotOptimize(summaries);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_Aggregate)->Apply(allCorpora);
+
+void BM_EventAppendTo(benchmark::State& state) {
+    const auto& lines = cachedCorpus(corpusArg(state));
+    const auto events = Parser::parseMultiple(lines);
+    std::string out;
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        out.clear();
+        events[i].appendTo(out);
+        bytes += out.size();
+        benchmark::DoNotOptimize(out.data());
+        i = (i + 1) % events.size();
+    }
+    reportThroughput(state, state.iterations(), bytes);
+}
+BENCHMARK(BM_EventAppendTo)->Apply(allCorpora);
+
+void BM_SerializeBatch(benchmark::State& state) {
+    const auto& lines = cachedCorpus(corpusArg(state));
+    const auto all_events = Parser::parseMultiple(lines);
+    const std::span<const Event> events(all_events.data(), batch_size);
+    std::string out;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        out.clear();
+        Event::appendTo(events, out);
+        bytes += out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    reportThroughput(state, state.iterations() * batch_size, bytes);
+}
+BENCHMARK(BM_SerializeBatch)->Apply(allCorpora);
+
+void BM_GetExtension(benchmark::State& state) {
+    const auto& lines = cachedCorpus(corpusArg(state));
+    const auto events = Parser::parseMultiple(lines);
+    size_t i = 0;
+    for (auto _ : state) {
+        const Event& event = events[i];
+        benchmark::DoNotOptimize(event.getSourceAddress());
+        benchmark::DoNotOptimize(event.getDestinationPort());
+        benchmark::DoNotOptimize(event.getExtension("act"));
+        benchmark::DoNotOptimize(event.getExtension("missing"));
+        i = (i + 1) % events.size();
+    }
+    // Items are individual lookups
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_GetExtension)->Apply(allCorpora);
+
+} // namespace
@@ -0,0 +1,162 @@
+#include "corpus.hpp"
+
+#include <array>
+#include <random>
+
+using namespace cef_cpp::bench;
+
+namespace {
+
+struct Device {
+    const char* vendor;
+    const char* product;
+    const char* version;
+};
+
+constexpr std::array<Device, 6> devices = {{
+    {"Palo Alto Networks", "PAN-OS", "10.1.0"},
+    {"Fortinet", "FortiGate", "7.2.5"},
+    {"Check Point", "VPN-1 & FireWall-1", "R81.10"},
+    {"Microsoft", "Microsoft Windows", "10.0"},
+    {"Trend Micro", "Deep Security Agent", "20.0.1"},
+    {"CrowdStrike", "Falcon", "6.45"}
+}};
+
+constexpr std::array<const char*, 6> actions = {
+    "allowed", "blocked", "dropped", "reset", "alert", "quarantined"
+};
+
+class Generator {
+public:
+    explicit Generator(const uint32_t seed) : rng_(seed) {}
+
+    std::string line(const Corpus corpus) {
+        switch (corpus) {
+        case Corpus::Short:
+            return shortEvent();
+        case Corpus::Wide:
+            return wideEvent();
+        case Corpus::EscapeHeavy:
+            return escapeHeavyEvent();
+        case Corpus::Mixed:
+        default:
+            switch (uniform(10)) {
+            case 0:
+            case 1:
+            case 2:
+            case 3:
+            case 4:
+                return shortEvent();
+            case 5:
+            case 6:
+            case 7:
+                return wideEvent();
+            default:
+                return escapeHeavyEvent();
+            }
+        }
+    }
+
+private:
+    std::mt19937 rng_;
+
+    size_t uniform(const size_t bound) { return rng_() % bound; }
+
+    std::string ip() {
+        return std::to_string(10 + uniform(200)) + "." + std::to_string(uniform(256)) + "." +
+               std::to_string(uniform(256)) + "." + std::to_string(1 + uniform(254));
+    }
+
+    std::string header(const std::string& class_id, const std::string& name) {
+        const Device& device = devices[uniform(devices.size())];
+        return std::string("CEF:0|") + device.vendor + "|" + device.product + "|" +
+               device.version + "|" + class_id + "|" + name + "|" +
+               std::to_string(uniform(11)) + "|";
+    }
+
+    std::string shortEvent() {
+        return header(std::to_string(100 + uniform(900)), "Connection attempt") +
+               "src=" + ip() + " dst=" + ip() + " spt=" + std::to_string(1024 + uniform(60000)) +
+               " dpt=" + std::to_string(uniform(2) ? 443 : 22) + " act=" +
+               actions[uniform(actions.size())];
+    }
+
+    std::string wideEvent() {
+        std::string line = header("TRAFFIC", "end");
+        line += "rt=" + std::to_string(1700000000000 + uniform(1000000000)) +
+                " src=" + ip() + " dst=" + ip() + " sourceTranslatedAddress=" + ip() +
+                " destinationTranslatedAddress=" + ip() +
+                " spt=" + std::to_string(1024 + uniform(60000)) +
+                " dpt=" + std::to_string(uniform(1024)) +
+                " sourceTranslatedPort=" + std::to_string(1024 + uniform(60000)) +
+                " destinationTranslatedPort=" + std::to_string(uniform(1024)) +
+                " proto=TCP act=" + actions[uniform(actions.size())] +
+                " suser=user" + std::to_string(uniform(5000)) +
+                " duser= deviceInboundInterface=ethernet1/1 deviceOutboundInterface=ethernet1/2"
+                " in=" + std::to_string(uniform(1000000)) +
+                " out=" + std::to_string(uniform(1000000)) +
+                " cnt=" + std::to_string(1 + uniform(20)) +
+                " deviceExternalId=0123456789 dvchost=fw-" + std::to_string(uniform(16)) +
+                " app=ssl cat=business-and-economy msg=Session ended after aged-out timeout";
+        for (int i = 1; i <= 6; ++i) {
+            const auto n = std::to_string(i);
+            line += " cs" + n + "Label=Custom String " + n + " cs" + n + "=value " +
+                    std::to_string(uniform(100000));
+            line += " cn" + n + "Label=Custom Number " + n + " cn" + n + "=" +
+                    std::to_string(uniform(100000));
+        }
+        for (int i = 0; i < 12; ++i) {
+            line += " flexString" + std::to_string(i) + "=" + std::to_string(uniform(1000));
+        }
+        return line;
+    }
+
+    std::string escapeHeavyEvent() {
+        std::string line = header("4688", "Process created \\| elevated");
+        line += "src=" + ip() + " suser=CORP\\\\user" + std::to_string(uniform(5000)) +
+                " filePath=C:\\\\Windows\\\\System32\\\\cmd.exe"
+                " cs1Label=Command Line cs1=cmd.exe /c \"set A\\=1 && echo %A% \\| more\""
+                " request=https://example.com/search?q\\=cef&page\\=" +
+                std::to_string(uniform(100)) +
+                " msg=line one\\nline two\\r\\nkey\\=value pipe \\| backslash \\\\ end"
+                " act=" + actions[uniform(actions.size())];
+        return line;
+    }
+};
+
+} // namespace
+
+const char* cef_cpp::bench::corpusName(const Corpus corpus) {
+    switch (corpus) {
+    case Corpus::Short:
+        return "short";
+    case Corpus::Wide:
+        return "wide";
+    case Corpus::EscapeHeavy:
+        return "escape_heavy";
+    case Corpus::Mixed:
+        return "mixed";
+    default:
+        return "unknown";
+    }
+}
+
+std::vector<std::string> cef_cpp::bench::generateCorpus(const Corpus corpus,
+                                                       const size_t count,
+                                                       const uint32_t seed) {
+    Generator generator(seed);
+    std::vector<std::string> lines;
+    lines.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        lines.push_back(generator.line(corpus));
+    }
+    return lines;
+}
+
+size_t cef_cpp::bench::corpusBytes(const std::vector<std::string>& lines) {
+    size_t bytes = 0;
+    for (const auto& line : lines) {
+        bytes += line.size();
+    }
+    return bytes;
+}
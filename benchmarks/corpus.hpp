@@ -0,0 +1,39 @@
+#ifndef CEF_CPP_BENCH_CORPUS_H
+#define CEF_CPP_BENCH_CORPUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cef_cpp::bench {
+
+/**
+ * @brief Shapes of synthetic CEF traffic used by the benchmarks
+ */
+enum class Corpus {
+    // Few extensions, as sent by IDS and authentication sources
+    Short,
+    // 50+ extensions, as sent by firewalls
+    Wide,
+    // Values full of escaped separators, paths and command lines
+    EscapeHeavy,
+    // Random mix of the above across several vendors
+    Mixed
+};
+
+const char* corpusName(Corpus corpus);
+
+/**
+ * @brief Generate @p count deterministic CEF lines of the given shape
+ */
+std::vector<std::string> generateCorpus(Corpus corpus, size_t count, uint32_t seed = 42);
+
+/**
+ * @brief Total size of the lines in bytes
+ */
+size_t corpusBytes(const std::vector<std::string>& lines);
+
+} // namespace cef_cpp::bench
+
+#endif
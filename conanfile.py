@@ -13,6 +13,7 @@ class CefCppConan(ConanFile):
 
     def build_requirements(self):
         self.test_requires("gtest/1.16.0")
+        self.test_requires("benchmark/1.9.1")
 
     def configure(self):
         # Configure Boost options for better compatibility
@@ -38,7 +39,7 @@ class CefCppConan(ConanFile):
         self.options["boost"].without_program_options = True
         self.options["boost"].without_python = True
         self.options["boost"].without_random = True
-        self.options["boost"].without_regex = False
+        self.options["boost"].without_regex = True
         self.options["boost"].without_serialization = True
         self.options["boost"].without_stacktrace = True
         self.options["boost"].without_system = False
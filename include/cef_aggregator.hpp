@@ -0,0 +1,153 @@
+#ifndef CEF_CPP_CEF_AGGREGATOR_H
+#define CEF_CPP_CEF_AGGREGATOR_H
+
+#include "cef_event.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cef_cpp {
+
+/**
+ * @brief Options controlling how Aggregator merges events
+ */
+struct AggregatorOptions {
+    /**
+     * @brief Fields identifying duplicates
+     *
+     * Events that agree on these header fields and extensions are merged; an absent
+     * extension only matches an absent one. Defaults to the vendor, product, class ID
+     * and name.
+     */
+    std::shared_ptr<const Projection> key = std::make_shared<const Projection>(
+        std::vector<std::string>{},
+        std::initializer_list<Projection::HeaderField>{
+            Projection::HeaderField::DeviceVendor, Projection::HeaderField::DeviceProduct,
+            Projection::HeaderField::DeviceEventClassId, Projection::HeaderField::Name});
+
+    // Length of a window, counted from the first event of its key
+    std::chrono::milliseconds window = std::chrono::seconds(1);
+
+    /**
+     * @brief Maximum number of open windows
+     *
+     * Opening a window beyond it closes the oldest window of the same shard early, so
+     * memory stays bounded however many distinct keys arrive. The limit is rounded up
+     * to a multiple of the shard count.
+     */
+    size_t max_keys = size_t{1} << 20;
+};
+
+/**
+ * @brief Merges duplicate events within a time window
+ *
+ * The first event of a key opens a window. Later events with the same key only add to
+ * the window's count until the window closes, when the first event is emitted once with
+ * cnt set to the number of events merged (counting an event with a cnt of its own as
+ * that many) and start and end set to the times of the first and last of them.
+ *
+ * Windows are kept in shards, each guarded by its own lock, so add() scales with the
+ * number of threads inserting. Windows close when flush() finds them expired, when an
+ * event of their key arrives after they expired, or early when a shard is full.
+ *
+ * @code
+ * Aggregator aggregator([&](Event&& summary) { sink.write(summary); });
+ * parser_output.forEach([&](const Event& event) { aggregator.add(event); });
+ * aggregator.flush(); // periodically, e.g. once per window
+ * @endcode
+ */
+class Aggregator {
+public:
+    using Callback = std::function<void(Event&&)>;
+
+    /**
+     * @param callback Receives each summarized event; it is called from the thread
+     *                 that closed the window, outside of any lock, so it may be called
+     *                 concurrently
+     * @param options Key, window length and capacity
+     */
+    explicit Aggregator(Callback callback, AggregatorOptions options = {});
+
+    // Open windows are discarded; call flushAll() first to emit them
+    ~Aggregator();
+
+    Aggregator(const Aggregator&) = delete;
+    Aggregator& operator=(const Aggregator&) = delete;
+
+    /**
+     * @brief Merge @p event into the window of its key, opening one if needed
+     *
+     * @param now Arrival time of the event; windows are ordered by it, so it should not
+     *            go backwards by more than the threads' clock skew
+     */
+    void add(const Event& event, Timestamp now);
+    void add(const Event& event) { add(event, clockNow()); }
+
+    /**
+     * @brief Close and emit the windows that have expired by @p now
+     *
+     * @return Number of windows emitted
+     */
+    size_t flush(Timestamp now);
+    size_t flush() { return flush(clockNow()); }
+
+    /**
+     * @brief Close and emit every open window
+     *
+     * @return Number of windows emitted
+     */
+    size_t flushAll();
+
+    // Number of open windows
+    size_t size() const;
+
+    const AggregatorOptions& getOptions() const { return options_; }
+
+private:
+    static constexpr size_t kShardCount = 64;
+
+    struct Window {
+        std::string key;
+        Event event;
+        int64_t count = 0;
+        Timestamp first_seen;
+        Timestamp last_seen;
+    };
+
+    // Windows are listed in the order they opened, so the expired ones are at the front
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::list<Window> windows;
+        std::unordered_map<std::string_view, std::list<Window>::iterator> index;
+    };
+
+    Callback callback_;
+    AggregatorOptions options_;
+    size_t shard_capacity_;
+    std::array<Shard, kShardCount> shards_;
+
+    void buildKey(const Event& event, std::string& key) const;
+    void emit(Window& window) const;
+
+    template <typename Predicate>
+    size_t closeWindows(Predicate expired);
+
+    static Timestamp clockNow() {
+        return std::chrono::time_point_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now());
+    }
+};
+
+} // namespace cef_cpp
+
+#endif
@@ -0,0 +1,311 @@
+#ifndef CEF_CPP_CEF_ARCHIVE_H
+#define CEF_CPP_CEF_ARCHIVE_H
+
+#include "cef_event.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cef_cpp {
+
+namespace detail {
+class MappedFile;
+}
+
+/**
+ * @brief Thrown when an archive is truncated, corrupt or of an unsupported version
+ */
+class ArchiveException : public std::runtime_error {
+public:
+    ArchiveException(const std::string& message, const size_t offset)
+        : std::runtime_error("Invalid archive at offset " + std::to_string(offset) + ": " +
+                             message),
+          offset_(offset) {
+    }
+
+    // Byte offset in the archive at which the error was detected
+    size_t getOffset() const { return offset_; }
+
+private:
+    size_t offset_;
+};
+
+/**
+ * @brief Writes events in the compact binary archive format
+ *
+ * An archive is the magic "CEFA", a format version byte and three reserved bytes,
+ * followed by blocks of up to block_size events. Each block starts with a codec byte
+ * (0, uncompressed; other values are reserved for block compression), the number of
+ * events and the payload size as varints. The payload is a dictionary of the distinct
+ * header values and extension keys of the block, then one varint-length-prefixed
+ * record per event that refers to the dictionary by index and stores extension values
+ * unescaped, so reading them back needs neither parsing nor unescaping.
+ *
+ * Errors are reported through the state of the output stream.
+ */
+class ArchiveWriter {
+public:
+    static constexpr size_t kDefaultBlockSize = 4096;
+
+    /**
+     * @brief Write to a stream; the stream must outlive the writer
+     *
+     * @param block_size Number of events per block
+     */
+    explicit ArchiveWriter(std::ostream& output, size_t block_size = kDefaultBlockSize);
+
+    // Writes the pending block
+    ~ArchiveWriter();
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    void write(const Event& event);
+    void write(std::span<const Event> events);
+
+    /**
+     * @brief Write the pending block, if any, and flush the stream
+     */
+    void flush();
+
+    // Number of events written so far
+    size_t getEventCount() const { return event_count_; }
+
+private:
+    struct Hash {
+        using is_transparent = void;
+
+        size_t operator()(const std::string_view str) const {
+            return std::hash<std::string_view>()(str);
+        }
+    };
+
+    std::ostream& output_;
+    size_t block_size_;
+    size_t event_count_ = 0;
+
+    // Dictionary of the pending block: entries in index order point at the map keys
+    std::unordered_map<std::string, uint32_t, Hash, std::equal_to<>> dictionary_index_;
+    std::vector<std::string_view> dictionary_;
+    std::string records_;
+    std::string record_;
+    size_t block_events_ = 0;
+
+    uint32_t indexOf(std::string_view str);
+    void writeBlock();
+};
+
+class ArchiveReader;
+
+/**
+ * @brief View of one event in an archive
+ *
+ * Header fields, syslog metadata and extension values are views into the archive data,
+ * already unescaped. Extensions are decoded on access only. A view refers to the block
+ * it was read from and is invalidated when the reader moves to the next block.
+ */
+class ArchivedEvent {
+public:
+    int getVersion() const { return version_; }
+    Event::Severity getSeverity() const { return severity_; }
+    std::string_view getDeviceVendor() const { return dictionary_[device_vendor_]; }
+    std::string_view getDeviceProduct() const { return dictionary_[device_product_]; }
+    std::string_view getDeviceVersion() const { return dictionary_[device_version_]; }
+
+    std::string_view getDeviceEventClassId() const {
+        return dictionary_[device_event_class_id_];
+    }
+
+    std::string_view getName() const { return dictionary_[name_]; }
+
+    int getSyslogPriority() const { return syslog_priority_; }
+    std::string_view getSyslogTimestamp() const { return syslog_timestamp_; }
+    std::string_view getSyslogHostname() const { return dictionary_[syslog_hostname_]; }
+    std::string_view getSyslogAppName() const { return dictionary_[syslog_app_name_]; }
+
+    size_t getExtensionCount() const { return extension_count_; }
+    std::optional<std::string_view> getExtension(std::string_view key) const;
+
+    /**
+     * @brief Pass each extension key and value to @p callback, in key order
+     */
+    template <typename Callback>
+    void forEachExtension(Callback&& callback) const {
+        const char* pos = extensions_.data();
+        std::string_view key;
+        std::string_view value;
+        for (size_t i = 0; i < extension_count_; ++i) {
+            readExtension(pos, key, value);
+            callback(key, value);
+        }
+    }
+
+    /**
+     * @brief Copy into an owning Event
+     *
+     * Header strings are interned once per block rather than once per event.
+     */
+    Event toEvent() const;
+
+private:
+    friend class ArchiveReader;
+
+    const ArchiveReader* reader_ = nullptr;
+    const std::string_view* dictionary_ = nullptr;
+
+    int version_ = 0;
+    Event::Severity severity_ = Event::Severity::Unknown;
+    uint32_t device_vendor_ = 0;
+    uint32_t device_product_ = 0;
+    uint32_t device_version_ = 0;
+    uint32_t device_event_class_id_ = 0;
+    uint32_t name_ = 0;
+    int syslog_priority_ = -1;
+    std::string_view syslog_timestamp_;
+    uint32_t syslog_hostname_ = 0;
+    uint32_t syslog_app_name_ = 0;
+
+    // Encoded extensions, bounded by the end of the record
+    size_t extension_count_ = 0;
+    std::string_view extensions_;
+
+    void readExtension(const char*& pos, std::string_view& key,
+                       std::string_view& value) const;
+};
+
+/**
+ * @brief Reads an archive written by ArchiveWriter
+ *
+ * Files are memory-mapped, so reading is bounded by I/O and the cost of building
+ * events, not by parsing. Use nextView() to inspect events without copying them.
+ *
+ * @code
+ * ArchiveReader reader("2024-11-14.cefa");
+ * for (const Event& event : reader) { ... }
+ * @endcode
+ */
+class ArchiveReader {
+public:
+    /**
+     * @brief Input iterator yielding the remaining events of an ArchiveReader
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Event;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Event*;
+        using reference = const Event&;
+
+        Iterator() = default;
+
+        explicit Iterator(ArchiveReader* reader) : reader_(reader) { ++*this; }
+
+        reference operator*() const { return *current_; }
+        pointer operator->() const { return &*current_; }
+
+        Iterator& operator++() {
+            current_ = reader_->next();
+            if (!current_) {
+                reader_ = nullptr;
+            }
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(const Iterator& other) const { return reader_ == other.reader_; }
+
+    private:
+        ArchiveReader* reader_ = nullptr;
+        std::optional<Event> current_;
+    };
+
+    /**
+     * @brief Map and read the archive at @p path
+     *
+     * @throws std::system_error if the file cannot be opened or mapped
+     * @throws ArchiveException if the file is not an archive
+     */
+    explicit ArchiveReader(const std::string& path);
+
+    /**
+     * @brief Read an archive held in memory; @p data must outlive the reader
+     *
+     * @throws ArchiveException if the data is not an archive
+     */
+    static ArchiveReader fromBuffer(std::string_view data);
+
+    ArchiveReader(ArchiveReader&&) noexcept;
+    ArchiveReader& operator=(ArchiveReader&&) noexcept;
+    ~ArchiveReader();
+
+    /**
+     * @brief Read the next event without copying it
+     *
+     * @return View valid until the reader moves past its block, or std::nullopt at the
+     *         end of the archive
+     * @throws ArchiveException if the archive is truncated or corrupt
+     */
+    std::optional<ArchivedEvent> nextView();
+
+    /**
+     * @brief Read the next event
+     *
+     * @return Event, or std::nullopt at the end of the archive
+     * @throws ArchiveException if the archive is truncated or corrupt
+     */
+    std::optional<Event> next();
+
+    /**
+     * @brief Read all remaining events and pass each one to @p callback
+     *
+     * @return Number of events read
+     */
+    template <typename Callback>
+    size_t forEach(Callback&& callback) {
+        size_t count = 0;
+        while (auto event = next()) {
+            callback(std::move(*event));
+            ++count;
+        }
+        return count;
+    }
+
+    Iterator begin() { return Iterator(this); }
+    Iterator end() { return Iterator(); }
+
+private:
+    friend class ArchivedEvent;
+
+    explicit ArchiveReader(std::string_view data, std::unique_ptr<detail::MappedFile> file);
+
+    std::unique_ptr<detail::MappedFile> file_;
+    std::string_view data_;
+    size_t offset_ = 0;
+
+    // Current block: its dictionary, the interned copies of the entries looked up so
+    // far (nullptr once the global table is full), its unread records and the number
+    // of events left in it
+    std::vector<std::string_view> dictionary_;
+    mutable std::vector<std::optional<const std::string*>> interned_;
+    std::string_view records_;
+    size_t block_events_ = 0;
+
+    bool readBlock();
+    const std::string* intern(uint32_t index) const;
+};
+
+} // namespace cef_cpp
+
+#endif
@@ -1,16 +1,50 @@
 #ifndef CEF_CPP_CEF_EVENT_H
 #define CEF_CPP_CEF_EVENT_H
 
+#include "cef_extension_keys.hpp"
+#include "cef_extension_map.hpp"
+#include "cef_projection.hpp"
+#include "cef_string_table.hpp"
+#include "cef_syslog.hpp"
+
+#include <atomic>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace cef_cpp {
 
+class EventView;
+
 /**
  * @brief Represents a parsed CEF (Common Event Format) event
  *
  * CEF Format: CEF:Version|Device Vendor|Device Product|Device Version|Device Event Class ID|Name|Severity|Extension
+ *
+ * The device vendor, product, version and event class ID are interned in
+ * StringTable::global(): they identify the sending device, so few distinct values
+ * usually exist. The table never frees its strings but has a byte budget; once it is
+ * spent, for instance by a sender varying these fields, new values are stored inline
+ * in each event instead. The name and the syslog hostname and app name can take
+ * unbounded sets of values, so each event always stores them inline.
+ * Extensions are kept in a flat ExtensionMap, so an event holding a few extensions
+ * costs about one allocation besides its name.
+ *
+ * Values of standard extension keys with a non-string type (see ExtensionKey) are
+ * converted once when they are stored and returned by the typed getters, such as
+ * getInteger() and getAddress(), without re-parsing the string.
+ *
+ * Events parsed with lazy extensions keep the raw extension text and decode a value on
+ * its first lookup. Const accessors may therefore write to the event; while values are
+ * still pending they serialize on a lock shared by a few events, so a lazy event can
+ * be read and copied from several threads like any other. Once getExtensions() or
+ * serialization has decoded every value, reads take no lock.
  */
 class Event {
 public:
@@ -28,34 +62,79 @@ public:
     // Constructor
     Event() = default;
 
+    // Written out to copy a lazy event under its lock
+    Event(const Event& other);
+    Event(Event&& other) noexcept;
+    Event& operator=(const Event& other);
+    Event& operator=(Event&& other) noexcept;
+    ~Event() = default;
+
     // CEF Header fields (required)
     void setVersion(const int version) { version_ = version; }
-    void setDeviceVendor(const std::string& vendor) { device_vendor_ = vendor; }
-    void setDeviceProduct(const std::string& product) { device_product_ = product; }
-    void setDeviceVersion(const std::string& version) { device_version_ = version; }
+    void setDeviceVendor(const std::string_view vendor) { device_vendor_.assign(vendor); }
 
-    void setDeviceEventClassId(const std::string& class_id) {
-        device_event_class_id_ = class_id;
+    void setDeviceProduct(const std::string_view product) {
+        device_product_.assign(product);
     }
 
-    void setName(const std::string& name) { name_ = name; }
+    void setDeviceVersion(const std::string_view version) {
+        device_version_.assign(version);
+    }
+
+    void setDeviceEventClassId(const std::string_view class_id) {
+        device_event_class_id_.assign(class_id);
+    }
+
+    void setName(const std::string_view name) { name_ = name; }
     void setSeverity(const Severity severity) { severity_ = severity; }
-    void setSeverity(int severity);
+    void setSeverity(int severity) { severity_ = toSeverity(severity); }
 
     // Getters for header fields
     int getVersion() const { return version_; }
-    const std::string& getDeviceVendor() const { return device_vendor_; }
-    const std::string& getDeviceProduct() const { return device_product_; }
-    const std::string& getDeviceVersion() const { return device_version_; }
-    const std::string& getDeviceEventClassId() const { return device_event_class_id_; }
+    const std::string& getDeviceVendor() const { return device_vendor_.get(); }
+    const std::string& getDeviceProduct() const { return device_product_.get(); }
+    const std::string& getDeviceVersion() const { return device_version_.get(); }
+    const std::string& getDeviceEventClassId() const { return device_event_class_id_.get(); }
     const std::string& getName() const { return name_; }
     Severity getSeverity() const { return severity_; }
 
+    // Metadata of the syslog header the event arrived in; empty/-1 if there was none
+    int getSyslogPriority() const { return syslog_priority_; }
+    const std::string& getSyslogTimestamp() const { return syslog_timestamp_; }
+    const std::string& getSyslogHostname() const { return syslog_hostname_; }
+    const std::string& getSyslogAppName() const { return syslog_app_name_; }
+
+    void setSyslogPriority(const int priority) { syslog_priority_ = priority; }
+
+    void setSyslogTimestamp(const std::string_view timestamp) {
+        syslog_timestamp_ = timestamp;
+    }
+
+    void setSyslogHostname(const std::string_view hostname) {
+        syslog_hostname_ = hostname;
+    }
+
+    void setSyslogAppName(const std::string_view app_name) {
+        syslog_app_name_ = app_name;
+    }
+
     // Extension fields (key-value pairs)
-    void setExtension(const std::string& key, const std::string& value);
-    std::optional<std::string> getExtension(const std::string& key) const;
+    void setExtension(std::string_view key, const std::string& value);
+    std::optional<std::string> getExtension(std::string_view key) const;
+
+    std::optional<std::string> getExtension(const ExtensionKey key) const {
+        return getExtension(getExtensionKeyInfo(key).key);
+    }
+
+    // Typed extension values; std::nullopt if the key is absent, has another type or
+    // its value could not be converted
+    std::optional<int64_t> getInteger(ExtensionKey key) const;
+    std::optional<double> getFloat(ExtensionKey key) const;
+    std::optional<IpAddress> getAddress(ExtensionKey key) const;
+    std::optional<Timestamp> getTimestamp(ExtensionKey key) const;
 
-    const std::unordered_map<std::string, std::string>& getExtensions() const {
+    const ExtensionMap& getExtensions() const {
+        materializeExtensions();
         return extensions_;
     }
 
@@ -77,6 +156,7 @@ public:
         return getExtension("dst");
     }
 
+    // Ports are strict: std::nullopt unless the whole value is an integer in [0, 65535]
     std::optional<int> getSourcePort() const;
     std::optional<int> getDestinationPort() const;
     std::optional<std::string> getProtocol() const { return getExtension("proto"); }
@@ -84,21 +164,207 @@ public:
 
     // Utility methods
     bool isValid() const;
+
+    /**
+     * @brief Serialize to a CEF line
+     *
+     * Pipes and backslashes in header fields and equal signs and backslashes in
+     * extension values are escaped, as are line breaks, so the line parses back to an
+     * equal event. Extensions are written in key order.
+     */
     std::string toString() const;
+
+    // Exact length of the line written by toString(), appendTo() and writeTo()
+    size_t getSerializedSize() const;
+
+    /**
+     * @brief Append the serialized line to @p out, growing it at most once
+     */
+    void appendTo(std::string& out) const;
+
+    /**
+     * @brief Write the serialized line to a caller-provided buffer
+     *
+     * @return Number of characters written, or 0 if @p buffer is shorter than
+     *         getSerializedSize() and nothing was written
+     */
+    size_t writeTo(std::span<char> buffer) const;
+
+    /**
+     * @brief Append the serialized lines of @p events to @p out, each followed by "\n"
+     *
+     * The output is sized for the whole batch up front, so serializing into a reused
+     * string does not allocate once its capacity suffices.
+     */
+    static void appendTo(std::span<const Event> events, std::string& out);
+
     static std::string severityToString(Severity severity);
+    static Severity toSeverity(int severity);
 
 private:
+    // A device header field: a string of the global table, or a copy once it is full
+    class DeviceField {
+    public:
+        const std::string& get() const { return interned_ != nullptr ? *interned_ : value_; }
+
+        void assign(const std::string_view str) {
+            assign(StringTable::global().tryIntern(str), str);
+        }
+
+        // Unescapes a raw header field first
+        void assignRaw(std::string_view raw);
+
+        // Takes @p interned if set, a copy of @p str otherwise
+        void assign(const std::string* interned, const std::string_view str) {
+            interned_ = interned;
+            if (interned_ != nullptr) {
+                // Keeps the capacity and makes copies of the event cheap
+                value_.clear();
+            } else {
+                value_.assign(str);
+            }
+        }
+
+    private:
+        const std::string* interned_ = &StringTable::empty();
+        std::string value_;
+    };
+
     // CEF Header fields
     int version_ = 0;
-    std::string device_vendor_;
-    std::string device_product_;
-    std::string device_version_;
-    std::string device_event_class_id_;
-    std::string name_;
     Severity severity_ = Severity::Unknown;
+    DeviceField device_vendor_;
+    DeviceField device_product_;
+    DeviceField device_version_;
+    DeviceField device_event_class_id_;
+    std::string name_;
+
+    // Syslog metadata
+    int syslog_priority_ = -1;
+    std::string syslog_timestamp_;
+    std::string syslog_hostname_;
+    std::string syslog_app_name_;
 
     // Extension fields
-    std::unordered_map<std::string, std::string> extensions_;
+    mutable ExtensionMap extensions_;
+
+    // Converted values of the typed standard keys present in extensions_
+    using TypedValue = std::variant<int64_t, double, IpAddress, Timestamp>;
+
+    struct TypedExtension {
+        ExtensionKey key;
+        TypedValue value;
+    };
+
+    mutable std::vector<TypedExtension> typed_extensions_;
+
+    // Lazily decoded extensions: offsets into the raw (escaped) extension text
+    struct LazyExtension {
+        size_t key_offset;
+        size_t key_length;
+        size_t value_offset;
+        size_t value_length;
+    };
+
+    mutable std::string lazy_raw_;
+    mutable std::vector<LazyExtension> lazy_extensions_;
+
+    // Set while lazy_extensions_ holds values not yet decoded
+    mutable std::atomic<bool> lazy_pending_{false};
+
+    friend class EventView;
+    friend class ArchivedEvent;
+    void setLazyExtensions(std::string_view extension_part,
+                           std::span<const std::pair<std::string_view, std::string_view>>
+                           extensions);
+    void materializeExtensions() const;
+    std::unique_lock<std::mutex> lockLazy() const;
+    const std::string* findExtension(std::string_view key) const;
+    const std::string& storeExtension(std::string_view key, std::string value) const;
+    const std::string& storeRawExtension(std::string_view key, std::string_view raw) const;
+    void convertExtension(std::string_view key, const std::string& value) const;
+    const TypedValue* findTypedExtension(ExtensionKey key) const;
+    char* write(char* out) const;
+};
+
+/**
+ * @brief Non-owning view of a parsed CEF event
+ *
+ * Header fields and extensions are std::string_views into the buffer handed to
+ * Parser::parseView, so parsing does not copy the line. Values are unescaped only when
+ * read through the decoding getters. A view must not outlive the buffer it refers to.
+ * The extension index is allocated from the memory resource given to the parser.
+ */
+class EventView {
+public:
+    using Severity = Event::Severity;
+    using RawExtension = std::pair<std::string_view, std::string_view>;
+
+    EventView() = default;
+
+    explicit EventView(std::pmr::memory_resource* resource) : extensions_(resource) {}
+
+    // Getters for header fields (unescaped on access)
+    int getVersion() const { return version_; }
+    std::string getDeviceVendor() const;
+    std::string getDeviceProduct() const;
+    std::string getDeviceVersion() const;
+    std::string getDeviceEventClassId() const;
+    std::string getName() const;
+    Severity getSeverity() const { return severity_; }
+
+    // Raw (still escaped) header fields
+    std::string_view getRawDeviceVendor() const { return device_vendor_; }
+    std::string_view getRawDeviceProduct() const { return device_product_; }
+    std::string_view getRawDeviceVersion() const { return device_version_; }
+    std::string_view getRawDeviceEventClassId() const { return device_event_class_id_; }
+    std::string_view getRawName() const { return name_; }
+
+    // Syslog header the line was wrapped in; format None if there was none
+    const SyslogHeader& getSyslogHeader() const { return syslog_header_; }
+
+    // Extension fields; for duplicate keys the last occurrence wins, as in Event
+    std::optional<std::string> getExtension(std::string_view key) const;
+    std::optional<std::string_view> getRawExtension(std::string_view key) const;
+
+    const std::pmr::vector<RawExtension>& getRawExtensions() const { return extensions_; }
+    std::string_view getRawExtensionPart() const { return extension_part_; }
+
+    /**
+     * @brief Copy into an owning Event
+     *
+     * @param lazy_extensions Copy the raw extension text only and decode each value on
+     *                        first access instead of unescaping every value now
+     * @param projection Copy only these fields; lazy_extensions is ignored when set
+     */
+    Event toEvent(bool lazy_extensions = false,
+                  const Projection* projection = nullptr) const;
+
+    /**
+     * @brief Overwrite @p event with a copy of this view, as toEvent() would build it
+     *
+     * Strings and extension storage of @p event are reused, so copying into a recycled
+     * event does not allocate once its capacity suffices.
+     */
+    void copyTo(Event& event, bool lazy_extensions = false,
+                const Projection* projection = nullptr) const;
+
+private:
+    friend class Parser;
+
+    // CEF Header fields
+    int version_ = 0;
+    std::string_view device_vendor_;
+    std::string_view device_product_;
+    std::string_view device_version_;
+    std::string_view device_event_class_id_;
+    std::string_view name_;
+    Severity severity_ = Severity::Unknown;
+    SyslogHeader syslog_header_;
+
+    // Extension fields in input order
+    std::string_view extension_part_;
+    std::pmr::vector<RawExtension> extensions_;
 };
 
 } // namespace cef_cpp
@@ -0,0 +1,85 @@
+#ifndef CEF_CPP_CEF_EVENT_BATCH_H
+#define CEF_CPP_CEF_EVENT_BATCH_H
+
+#include "cef_event.hpp"
+#include "cef_parser.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+
+namespace cef_cpp {
+
+/**
+ * @brief A batch of parsed events whose storage lives in a single arena
+ *
+ * Each added line is copied into a monotonic arena and parsed into an EventView whose
+ * extension index is carved from the same arena, so a batch performs a handful of
+ * large allocations instead of several per event, and frees everything at once when
+ * it is cleared or destroyed. Fields are unescaped when read, as with EventView.
+ *
+ * A batch is not thread-safe; use one batch per worker thread. A moved-from batch is
+ * empty and can be reused; it obtains a new arena on its next add().
+ */
+class EventBatch {
+public:
+    static constexpr size_t kDefaultArenaSize = 64 * 1024;
+
+    /**
+     * @param initial_arena_size Size of the first arena block; later blocks grow
+     *                           geometrically
+     * @param upstream Resource the arena obtains its blocks from
+     */
+    explicit EventBatch(size_t initial_arena_size = kDefaultArenaSize,
+                        std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    EventBatch(EventBatch&&) noexcept = default;
+    EventBatch& operator=(EventBatch&& other) noexcept;
+
+    /**
+     * @brief Copy a line into the arena and parse it
+     *
+     * @param options Honors syslog and filter, as Parser::tryParseView does
+     * @return Index of the new event, or the reason the line was rejected, which is
+     *         ParseErrorCode::Filtered for a line the filter rejects; the bytes of a
+     *         rejected line stay in the arena until the batch is cleared
+     */
+    ParseResult<size_t> tryAdd(std::string_view cef_line, const ParseOptions& options = {});
+
+    /**
+     * @brief Copy a line into the arena and parse it
+     *
+     * @throws ParseException if the line cannot be parsed or is filtered out
+     */
+    const EventView& add(std::string_view cef_line, const ParseOptions& options = {});
+
+    void reserve(size_t events);
+
+    /**
+     * @brief Drop all events and release the arena in one step
+     */
+    void clear();
+
+    size_t size() const { return events_.size(); }
+    bool empty() const { return events_.empty(); }
+
+    const EventView& operator[](const size_t index) const { return events_[index]; }
+
+    auto begin() const { return events_.begin(); }
+    auto end() const { return events_.end(); }
+
+    std::pmr::memory_resource* getResource() const { return arena_.get(); }
+
+private:
+    size_t initial_arena_size_;
+    std::pmr::memory_resource* upstream_;
+
+    // Declared before events_ so the arena outlives the views allocated from it
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+    std::pmr::vector<EventView> events_;
+};
+
+} // namespace cef_cpp
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef CEF_CPP_CEF_EVENT_COLUMNS_H
+#define CEF_CPP_CEF_EVENT_COLUMNS_H
+
+#include "cef_arrow.hpp"
+#include "cef_event.hpp"
+#include "cef_parser.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cef_cpp {
+
+/**
+ * @brief Nullable string column in the Arrow utf8 layout
+ *
+ * Values are stored back to back in one data buffer and delimited by int32 offsets;
+ * a validity bitmap (least significant bit first) marks the non-null rows.
+ */
+class StringColumn {
+public:
+    StringColumn() = default;
+
+    size_t size() const { return offsets_.size() - 1; }
+    size_t getNullCount() const { return null_count_; }
+
+    bool isValid(const size_t row) const { return validity_[row / 8] >> (row % 8) & 1; }
+
+    // Empty for null rows
+    std::string_view operator[](const size_t row) const {
+        const auto begin = static_cast<size_t>(offsets_[row]);
+        return std::string_view(data_).substr(begin, offsets_[row + 1] - begin);
+    }
+
+    std::span<const int32_t> getOffsets() const { return offsets_; }
+    std::string_view getData() const { return data_; }
+    std::span<const uint8_t> getValidity() const { return validity_; }
+
+    void append(std::string_view value);
+    // Append the unescaped form of a raw CEF value
+    void appendEscaped(std::string_view raw);
+    void appendNull();
+    void clear();
+
+private:
+    std::vector<int32_t> offsets_{0};
+    std::string data_;
+    std::vector<uint8_t> validity_;
+    size_t null_count_ = 0;
+
+    void finishRow(bool valid);
+};
+
+/**
+ * @brief Dictionary-encoded string column
+ *
+ * Each row holds an int32 index into a dictionary of the distinct values, which keeps
+ * low-cardinality header fields such as the device vendor small and cheap to group by.
+ * clear() keeps the capacity of the lookup table for the next batch.
+ */
+class DictionaryColumn {
+public:
+    size_t size() const { return indices_.size(); }
+
+    std::string_view operator[](const size_t row) const {
+        return dictionary_[indices_[row]];
+    }
+
+    std::span<const int32_t> getIndices() const { return indices_; }
+    const StringColumn& getDictionary() const { return dictionary_; }
+
+    void append(std::string_view value);
+    // Append the unescaped form of a raw CEF field
+    void appendEscaped(std::string_view raw);
+    void clear();
+
+private:
+    std::vector<int32_t> indices_;
+    StringColumn dictionary_;
+    // Open-addressing table of dictionary indices, -1 for free slots; the keys are
+    // the dictionary entries themselves
+    std::vector<int32_t> slots_;
+    std::string scratch_;
+
+    void grow();
+};
+
+/**
+ * @brief Column-oriented batch of CEF events
+ *
+ * Lines are parsed straight into per-field columns without building Event objects:
+ * int32 versions, dictionary-encoded vendor, product, device version, class ID and
+ * name, int8 severities (null when unknown) and one nullable string column per
+ * selected extension key. Scans over a few fields touch only those columns.
+ *
+ * exportToArrow() hands the columns to any consumer of the Arrow C Data Interface as a
+ * struct array without copying.
+ */
+class EventColumns {
+public:
+    /**
+     * @param extension_keys Extension keys to store as columns; others are skipped
+     */
+    explicit EventColumns(std::vector<std::string> extension_keys = {});
+
+    EventColumns(EventColumns&&) = default;
+    EventColumns& operator=(EventColumns&&) = default;
+
+    /**
+     * @brief Parse a line and append it as a row
+     *
+     * @param cef_line The CEF formatted string to parse
+     * @param options Parsing options; lazy_extensions does not apply
+     * @return Index of the new row, or the reason the line was rejected, in which case
+     *         no column changes
+     */
+    ParseResult<size_t> tryAppend(std::string_view cef_line,
+                                  const ParseOptions& options = {});
+
+    /**
+     * @brief Append an already parsed event as a row
+     */
+    void append(const Event& event);
+
+    size_t size() const { return versions_.size(); }
+    bool empty() const { return versions_.empty(); }
+    void reserve(size_t rows);
+    void clear();
+
+    std::span<const int32_t> getVersion() const { return versions_; }
+    const DictionaryColumn& getDeviceVendor() const { return header_[0]; }
+    const DictionaryColumn& getDeviceProduct() const { return header_[1]; }
+    const DictionaryColumn& getDeviceVersion() const { return header_[2]; }
+    const DictionaryColumn& getDeviceEventClassId() const { return header_[3]; }
+    const DictionaryColumn& getName() const { return header_[4]; }
+
+    // Severity as in Event::Severity, -1 for unknown
+    std::span<const int8_t> getSeverity() const { return severities_; }
+
+    const std::vector<std::string>& getExtensionKeys() const { return extension_keys_; }
+
+    // Column of @p key, or nullptr if the key was not selected
+    const StringColumn* getExtension(std::string_view key) const;
+
+    /**
+     * @brief Move the columns into an Arrow struct array
+     *
+     * Fields are named version, device_vendor, device_product, device_version,
+     * device_event_class_id, name, severity and then the extension keys. Buffers are
+     * handed over without copying and freed by the release callbacks; afterwards this
+     * object is empty and keeps its extension keys.
+     *
+     * @param schema Receives the schema of the struct array
+     * @param array Receives the struct array
+     */
+    void exportToArrow(ArrowSchema* schema, ArrowArray* array);
+
+private:
+    std::vector<std::string> extension_keys_;
+    std::unordered_map<std::string_view, size_t> extension_index_;
+
+    std::vector<int32_t> versions_;
+    std::array<DictionaryColumn, 5> header_;
+    std::vector<int8_t> severities_;
+    std::vector<uint8_t> severity_validity_;
+    size_t severity_null_count_ = 0;
+    std::vector<StringColumn> extensions_;
+
+    // Per-row scratch: the last raw value seen for each extension column
+    std::vector<std::string_view> row_values_;
+    std::vector<bool> row_present_;
+    // Backs the extension index of the view being appended; reset for every line
+    std::unique_ptr<std::byte[]> view_buffer_;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> view_resource_;
+
+    void appendSeverity(Event::Severity severity);
+};
+
+} // namespace cef_cpp
+
+#endif
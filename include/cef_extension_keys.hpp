@@ -0,0 +1,414 @@
+#ifndef CEF_CPP_CEF_EXTENSION_KEYS_H
+#define CEF_CPP_CEF_EXTENSION_KEYS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace cef_cpp {
+
+/**
+ * @brief Data types of the standard CEF extension keys
+ */
+enum class ExtensionType : uint8_t {
+    String,
+    Integer,
+    Long,
+    Float,
+    // IPv4 or IPv6 address
+    Address,
+    // Milliseconds since the epoch or "MMM dd yyyy HH:mm:ss[.SSS]"
+    Timestamp
+};
+
+/**
+ * @brief Standard CEF extension keys, named after their full ArcSight names
+ */
+enum class ExtensionKey : uint8_t {
+    DeviceAction,
+    ApplicationProtocol,
+    DeviceCustomIPv6Address1,
+    DeviceCustomIPv6Address1Label,
+    DeviceCustomIPv6Address3,
+    DeviceCustomIPv6Address3Label,
+    DeviceCustomIPv6Address4,
+    DeviceCustomIPv6Address4Label,
+    DeviceEventCategory,
+    DeviceCustomFloatingPoint1,
+    DeviceCustomFloatingPoint1Label,
+    DeviceCustomFloatingPoint2,
+    DeviceCustomFloatingPoint2Label,
+    DeviceCustomFloatingPoint3,
+    DeviceCustomFloatingPoint3Label,
+    DeviceCustomFloatingPoint4,
+    DeviceCustomFloatingPoint4Label,
+    DeviceCustomNumber1,
+    DeviceCustomNumber1Label,
+    DeviceCustomNumber2,
+    DeviceCustomNumber2Label,
+    DeviceCustomNumber3,
+    DeviceCustomNumber3Label,
+    BaseEventCount,
+    DeviceCustomString1,
+    DeviceCustomString1Label,
+    DeviceCustomString2,
+    DeviceCustomString2Label,
+    DeviceCustomString3,
+    DeviceCustomString3Label,
+    DeviceCustomString4,
+    DeviceCustomString4Label,
+    DeviceCustomString5,
+    DeviceCustomString5Label,
+    DeviceCustomString6,
+    DeviceCustomString6Label,
+    DestinationDnsDomain,
+    DestinationServiceName,
+    DestinationTranslatedAddress,
+    DestinationTranslatedPort,
+    DeviceCustomDate1,
+    DeviceCustomDate1Label,
+    DeviceCustomDate2,
+    DeviceCustomDate2Label,
+    DeviceDirection,
+    DeviceDnsDomain,
+    DeviceExternalId,
+    DeviceFacility,
+    DeviceInboundInterface,
+    DeviceNtDomain,
+    DeviceOutboundInterface,
+    DevicePayloadId,
+    DeviceProcessName,
+    DeviceTranslatedAddress,
+    DestinationHostName,
+    DestinationGeoLatitude,
+    DestinationGeoLongitude,
+    DestinationMacAddress,
+    DestinationNtDomain,
+    DestinationProcessId,
+    DestinationUserPrivileges,
+    DestinationProcessName,
+    DestinationPort,
+    DestinationAddress,
+    DeviceTimeZone,
+    DestinationUserId,
+    DestinationUserName,
+    DeviceAddress,
+    DeviceHostName,
+    DeviceMacAddress,
+    DeviceProcessId,
+    EndTime,
+    ExternalId,
+    FileCreateTime,
+    FileHash,
+    FileId,
+    FileModificationTime,
+    FilePath,
+    FilePermission,
+    FileType,
+    FlexDate1,
+    FlexDate1Label,
+    FlexString1,
+    FlexString1Label,
+    FlexString2,
+    FlexString2Label,
+    FileName,
+    FileSize,
+    BytesIn,
+    Message,
+    OldFileCreateTime,
+    OldFileHash,
+    OldFileId,
+    OldFileModificationTime,
+    OldFileName,
+    OldFilePath,
+    OldFilePermission,
+    OldFileSize,
+    OldFileType,
+    BytesOut,
+    EventOutcome,
+    TransportProtocol,
+    Reason,
+    RequestUrl,
+    RequestClientApplication,
+    RequestContext,
+    RequestCookies,
+    RequestMethod,
+    DeviceReceiptTime,
+    SourceHostName,
+    SourceGeoLatitude,
+    SourceGeoLongitude,
+    SourceMacAddress,
+    SourceNtDomain,
+    SourceDnsDomain,
+    SourceServiceName,
+    SourceTranslatedAddress,
+    SourceTranslatedPort,
+    SourceProcessId,
+    SourceUserPrivileges,
+    SourceProcessName,
+    SourcePort,
+    SourceAddress,
+    StartTime,
+    SourceUserId,
+    SourceUserName,
+    Type,
+};
+
+/**
+ * @brief Key name, full name and type of a standard CEF extension key
+ */
+struct ExtensionKeyInfo {
+    std::string_view key;
+    std::string_view full_name;
+    ExtensionType type;
+};
+
+// Indexed by ExtensionKey
+inline constexpr auto kExtensionKeys = std::to_array<ExtensionKeyInfo>({
+    {"act", "deviceAction", ExtensionType::String},
+    {"app", "applicationProtocol", ExtensionType::String},
+    {"c6a1", "deviceCustomIPv6Address1", ExtensionType::Address},
+    {"c6a1Label", "deviceCustomIPv6Address1Label", ExtensionType::String},
+    {"c6a3", "deviceCustomIPv6Address3", ExtensionType::Address},
+    {"c6a3Label", "deviceCustomIPv6Address3Label", ExtensionType::String},
+    {"c6a4", "deviceCustomIPv6Address4", ExtensionType::Address},
+    {"c6a4Label", "deviceCustomIPv6Address4Label", ExtensionType::String},
+    {"cat", "deviceEventCategory", ExtensionType::String},
+    {"cfp1", "deviceCustomFloatingPoint1", ExtensionType::Float},
+    {"cfp1Label", "deviceCustomFloatingPoint1Label", ExtensionType::String},
+    {"cfp2", "deviceCustomFloatingPoint2", ExtensionType::Float},
+    {"cfp2Label", "deviceCustomFloatingPoint2Label", ExtensionType::String},
+    {"cfp3", "deviceCustomFloatingPoint3", ExtensionType::Float},
+    {"cfp3Label", "deviceCustomFloatingPoint3Label", ExtensionType::String},
+    {"cfp4", "deviceCustomFloatingPoint4", ExtensionType::Float},
+    {"cfp4Label", "deviceCustomFloatingPoint4Label", ExtensionType::String},
+    {"cn1", "deviceCustomNumber1", ExtensionType::Long},
+    {"cn1Label", "deviceCustomNumber1Label", ExtensionType::String},
+    {"cn2", "deviceCustomNumber2", ExtensionType::Long},
+    {"cn2Label", "deviceCustomNumber2Label", ExtensionType::String},
+    {"cn3", "deviceCustomNumber3", ExtensionType::Long},
+    {"cn3Label", "deviceCustomNumber3Label", ExtensionType::String},
+    {"cnt", "baseEventCount", ExtensionType::Integer},
+    {"cs1", "deviceCustomString1", ExtensionType::String},
+    {"cs1Label", "deviceCustomString1Label", ExtensionType::String},
+    {"cs2", "deviceCustomString2", ExtensionType::String},
+    {"cs2Label", "deviceCustomString2Label", ExtensionType::String},
+    {"cs3", "deviceCustomString3", ExtensionType::String},
+    {"cs3Label", "deviceCustomString3Label", ExtensionType::String},
+    {"cs4", "deviceCustomString4", ExtensionType::String},
+    {"cs4Label", "deviceCustomString4Label", ExtensionType::String},
+    {"cs5", "deviceCustomString5", ExtensionType::String},
+    {"cs5Label", "deviceCustomString5Label", ExtensionType::String},
+    {"cs6", "deviceCustomString6", ExtensionType::String},
+    {"cs6Label", "deviceCustomString6Label", ExtensionType::String},
+    {"destinationDnsDomain", "destinationDnsDomain", ExtensionType::String},
+    {"destinationServiceName", "destinationServiceName", ExtensionType::String},
+    {"destinationTranslatedAddress", "destinationTranslatedAddress",
+     ExtensionType::Address},
+    {"destinationTranslatedPort", "destinationTranslatedPort", ExtensionType::Integer},
+    {"deviceCustomDate1", "deviceCustomDate1", ExtensionType::Timestamp},
+    {"deviceCustomDate1Label", "deviceCustomDate1Label", ExtensionType::String},
+    {"deviceCustomDate2", "deviceCustomDate2", ExtensionType::Timestamp},
+    {"deviceCustomDate2Label", "deviceCustomDate2Label", ExtensionType::String},
+    {"deviceDirection", "deviceDirection", ExtensionType::Integer},
+    {"deviceDnsDomain", "deviceDnsDomain", ExtensionType::String},
+    {"deviceExternalId", "deviceExternalId", ExtensionType::String},
+    {"deviceFacility", "deviceFacility", ExtensionType::String},
+    {"deviceInboundInterface", "deviceInboundInterface", ExtensionType::String},
+    {"deviceNtDomain", "deviceNtDomain", ExtensionType::String},
+    {"deviceOutboundInterface", "deviceOutboundInterface", ExtensionType::String},
+    {"devicePayloadId", "devicePayloadId", ExtensionType::String},
+    {"deviceProcessName", "deviceProcessName", ExtensionType::String},
+    {"deviceTranslatedAddress", "deviceTranslatedAddress", ExtensionType::Address},
+    {"dhost", "destinationHostName", ExtensionType::String},
+    {"dlat", "destinationGeoLatitude", ExtensionType::Float},
+    {"dlong", "destinationGeoLongitude", ExtensionType::Float},
+    {"dmac", "destinationMacAddress", ExtensionType::String},
+    {"dntdom", "destinationNtDomain", ExtensionType::String},
+    {"dpid", "destinationProcessId", ExtensionType::Integer},
+    {"dpriv", "destinationUserPrivileges", ExtensionType::String},
+    {"dproc", "destinationProcessName", ExtensionType::String},
+    {"dpt", "destinationPort", ExtensionType::Integer},
+    {"dst", "destinationAddress", ExtensionType::Address},
+    {"dtz", "deviceTimeZone", ExtensionType::String},
+    {"duid", "destinationUserId", ExtensionType::String},
+    {"duser", "destinationUserName", ExtensionType::String},
+    {"dvc", "deviceAddress", ExtensionType::Address},
+    {"dvchost", "deviceHostName", ExtensionType::String},
+    {"dvcmac", "deviceMacAddress", ExtensionType::String},
+    {"dvcpid", "deviceProcessId", ExtensionType::Integer},
+    {"end", "endTime", ExtensionType::Timestamp},
+    {"externalId", "externalId", ExtensionType::String},
+    {"fileCreateTime", "fileCreateTime", ExtensionType::Timestamp},
+    {"fileHash", "fileHash", ExtensionType::String},
+    {"fileId", "fileId", ExtensionType::String},
+    {"fileModificationTime", "fileModificationTime", ExtensionType::Timestamp},
+    {"filePath", "filePath", ExtensionType::String},
+    {"filePermission", "filePermission", ExtensionType::String},
+    {"fileType", "fileType", ExtensionType::String},
+    {"flexDate1", "flexDate1", ExtensionType::Timestamp},
+    {"flexDate1Label", "flexDate1Label", ExtensionType::String},
+    {"flexString1", "flexString1", ExtensionType::String},
+    {"flexString1Label", "flexString1Label", ExtensionType::String},
+    {"flexString2", "flexString2", ExtensionType::String},
+    {"flexString2Label", "flexString2Label", ExtensionType::String},
+    {"fname", "fileName", ExtensionType::String},
+    {"fsize", "fileSize", ExtensionType::Integer},
+    {"in", "bytesIn", ExtensionType::Integer},
+    {"msg", "message", ExtensionType::String},
+    {"oldFileCreateTime", "oldFileCreateTime", ExtensionType::Timestamp},
+    {"oldFileHash", "oldFileHash", ExtensionType::String},
+    {"oldFileId", "oldFileId", ExtensionType::String},
+    {"oldFileModificationTime", "oldFileModificationTime", ExtensionType::Timestamp},
+    {"oldFileName", "oldFileName", ExtensionType::String},
+    {"oldFilePath", "oldFilePath", ExtensionType::String},
+    {"oldFilePermission", "oldFilePermission", ExtensionType::String},
+    {"oldFileSize", "oldFileSize", ExtensionType::Integer},
+    {"oldFileType", "oldFileType", ExtensionType::String},
+    {"out", "bytesOut", ExtensionType::Integer},
+    {"outcome", "eventOutcome", ExtensionType::String},
+    {"proto", "transportProtocol", ExtensionType::String},
+    {"reason", "reason", ExtensionType::String},
+    {"request", "requestUrl", ExtensionType::String},
+    {"requestClientApplication", "requestClientApplication", ExtensionType::String},
+    {"requestContext", "requestContext", ExtensionType::String},
+    {"requestCookies", "requestCookies", ExtensionType::String},
+    {"requestMethod", "requestMethod", ExtensionType::String},
+    {"rt", "deviceReceiptTime", ExtensionType::Timestamp},
+    {"shost", "sourceHostName", ExtensionType::String},
+    {"slat", "sourceGeoLatitude", ExtensionType::Float},
+    {"slong", "sourceGeoLongitude", ExtensionType::Float},
+    {"smac", "sourceMacAddress", ExtensionType::String},
+    {"sntdom", "sourceNtDomain", ExtensionType::String},
+    {"sourceDnsDomain", "sourceDnsDomain", ExtensionType::String},
+    {"sourceServiceName", "sourceServiceName", ExtensionType::String},
+    {"sourceTranslatedAddress", "sourceTranslatedAddress", ExtensionType::Address},
+    {"sourceTranslatedPort", "sourceTranslatedPort", ExtensionType::Integer},
+    {"spid", "sourceProcessId", ExtensionType::Integer},
+    {"spriv", "sourceUserPrivileges", ExtensionType::String},
+    {"sproc", "sourceProcessName", ExtensionType::String},
+    {"spt", "sourcePort", ExtensionType::Integer},
+    {"src", "sourceAddress", ExtensionType::Address},
+    {"start", "startTime", ExtensionType::Timestamp},
+    {"suid", "sourceUserId", ExtensionType::String},
+    {"suser", "sourceUserName", ExtensionType::String},
+    {"type", "type", ExtensionType::Integer},
+});
+
+static_assert(kExtensionKeys.size() == static_cast<size_t>(ExtensionKey::Type) + 1,
+              "kExtensionKeys must list every ExtensionKey in declaration order");
+
+namespace detail {
+
+constexpr uint32_t hashExtensionKey(const std::string_view key) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char c : key) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+inline constexpr size_t kExtensionKeySlots = 512;
+inline constexpr uint8_t kNoExtensionKey = 0xff;
+
+// Open-addressing table from key hash to ExtensionKey, filled at compile time
+constexpr std::array<uint8_t, kExtensionKeySlots> makeExtensionKeySlots() {
+    std::array<uint8_t, kExtensionKeySlots> slots{};
+    slots.fill(kNoExtensionKey);
+    for (size_t i = 0; i < kExtensionKeys.size(); ++i) {
+        size_t slot = hashExtensionKey(kExtensionKeys[i].key) % kExtensionKeySlots;
+        while (slots[slot] != kNoExtensionKey) {
+            slot = (slot + 1) % kExtensionKeySlots;
+        }
+        slots[slot] = static_cast<uint8_t>(i);
+    }
+    return slots;
+}
+
+inline constexpr std::array<uint8_t, kExtensionKeySlots> kExtensionKeySlotTable =
+    makeExtensionKeySlots();
+
+} // namespace detail
+
+/**
+ * @brief Look up the standard extension key named @p key
+ *
+ * @return The key, or std::nullopt for custom keys
+ */
+constexpr std::optional<ExtensionKey> findExtensionKey(const std::string_view key) {
+    size_t slot = detail::hashExtensionKey(key) % detail::kExtensionKeySlots;
+    while (detail::kExtensionKeySlotTable[slot] != detail::kNoExtensionKey) {
+        const uint8_t index = detail::kExtensionKeySlotTable[slot];
+        if (kExtensionKeys[index].key == key) {
+            return static_cast<ExtensionKey>(index);
+        }
+        slot = (slot + 1) % detail::kExtensionKeySlots;
+    }
+    return std::nullopt;
+}
+
+constexpr const ExtensionKeyInfo& getExtensionKeyInfo(const ExtensionKey key) {
+    return kExtensionKeys[static_cast<size_t>(key)];
+}
+
+/**
+ * @brief Translate a full key name (sourceAddress) to the key used on the wire (src)
+ *
+ * @return The key name, or @p name itself if it is not a full name
+ */
+constexpr std::string_view toExtensionKeyName(const std::string_view name) {
+    for (const ExtensionKeyInfo& info : kExtensionKeys) {
+        if (info.full_name == name) {
+            return info.key;
+        }
+    }
+    return name;
+}
+
+static_assert(findExtensionKey("src") == ExtensionKey::SourceAddress);
+static_assert(findExtensionKey("type") == ExtensionKey::Type);
+static_assert(!findExtensionKey("sourceAddress").has_value());
+static_assert(toExtensionKeyName("sourceAddress") == "src");
+static_assert(toExtensionKeyName("cs1") == "cs1");
+
+/**
+ * @brief IPv4 or IPv6 address in network byte order
+ */
+struct IpAddress {
+    enum class Family : uint8_t {
+        V4,
+        V6
+    };
+
+    Family family = Family::V4;
+    // IPv4 addresses use the first 4 bytes
+    std::array<uint8_t, 16> bytes{};
+
+    /**
+     * @brief Parse dotted IPv4 or textual IPv6 notation
+     */
+    static std::optional<IpAddress> parse(std::string_view str);
+
+    std::string toString() const;
+
+    bool operator==(const IpAddress& other) const = default;
+};
+
+using Timestamp = std::chrono::sys_time<std::chrono::milliseconds>;
+
+/**
+ * @brief Parse a CEF timestamp
+ *
+ * Accepts milliseconds since the epoch and "MMM dd yyyy HH:mm:ss[.SSS]", optionally
+ * followed by a UTC/GMT/Z zone. Other zones and formats without a year are rejected.
+ */
+std::optional<Timestamp> parseTimestamp(std::string_view str);
+
+} // namespace cef_cpp
+
+#endif
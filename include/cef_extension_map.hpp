@@ -0,0 +1,189 @@
+#ifndef CEF_CPP_CEF_EXTENSION_MAP_H
+#define CEF_CPP_CEF_EXTENSION_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cef_cpp {
+
+/**
+ * @brief Flat map of CEF extension keys to values, sorted by key
+ *
+ * Events typically carry a few dozen extensions at most, with short keys that fit the
+ * small-string buffer. Storing them in one contiguous vector costs a single allocation
+ * per event instead of one node per entry, and lookups are a binary search over
+ * adjacent memory. Insertion is linear in the number of entries.
+ *
+ * Iteration yields std::pair<std::string, std::string> in key order.
+ *
+ * Cleared and erased entries are kept as spares, and new entries take over their
+ * strings, so refilling a map with values of similar size does not allocate.
+ */
+class ExtensionMap {
+public:
+    using key_type = std::string;
+    using mapped_type = std::string;
+    using value_type = std::pair<std::string, std::string>;
+    using size_type = size_t;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    ExtensionMap() = default;
+
+    ExtensionMap(const std::initializer_list<value_type> entries) {
+        reserve(entries.size());
+        for (const auto& [key, value] : entries) {
+            insert_or_assign(key, value);
+        }
+    }
+
+    // Copies hold the entries only, not the spares
+    ExtensionMap(const ExtensionMap& other)
+        : entries_(other.begin(), other.end()), size_(other.size_) {}
+
+    ExtensionMap(ExtensionMap&& other) noexcept
+        : entries_(std::move(other.entries_)), size_(std::exchange(other.size_, 0)) {}
+
+    ExtensionMap& operator=(const ExtensionMap& other) {
+        if (this != &other) {
+            entries_.assign(other.begin(), other.end());
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    ExtensionMap& operator=(ExtensionMap&& other) noexcept {
+        entries_ = std::move(other.entries_);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void reserve(const size_type count) { entries_.reserve(count); }
+    void clear() { size_ = 0; }
+
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.begin() + static_cast<std::ptrdiff_t>(size_); }
+    const_iterator begin() const { return entries_.begin(); }
+
+    const_iterator end() const {
+        return entries_.begin() + static_cast<std::ptrdiff_t>(size_);
+    }
+
+    iterator find(const std::string_view key) {
+        const auto it = lowerBound(key);
+        return it != end() && it->first == key ? it : end();
+    }
+
+    const_iterator find(const std::string_view key) const {
+        return const_cast<ExtensionMap*>(this)->find(key);
+    }
+
+    bool contains(const std::string_view key) const { return find(key) != end(); }
+    size_type count(const std::string_view key) const { return contains(key) ? 1 : 0; }
+
+    const std::string& at(const std::string_view key) const {
+        const auto it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("ExtensionMap::at: no extension " + std::string(key));
+        }
+        return it->second;
+    }
+
+    std::string& operator[](const std::string_view key) {
+        return emplace(key, std::string()).first->second;
+    }
+
+    /**
+     * @brief Insert @p value under @p key unless the key is already present
+     *
+     * @return Iterator to the entry of @p key and whether it was inserted
+     */
+    std::pair<iterator, bool> emplace(const std::string_view key, std::string value) {
+        const auto it = lowerBound(key);
+        if (it != end() && it->first == key) {
+            return {it, false};
+        }
+        const auto inserted = insert(it, key);
+        inserted->second = std::move(value);
+        return {inserted, true};
+    }
+
+    /**
+     * @brief Set @p key to @p value, replacing any previous value
+     */
+    iterator insert_or_assign(const std::string_view key, std::string value) {
+        auto [it, inserted] = emplace(key, std::string());
+        it->second = std::move(value);
+        return it;
+    }
+
+    /**
+     * @brief Value of @p key for the caller to overwrite, inserting the key if needed
+     *
+     * Unlike operator[], a new entry takes over the string of a spare, so the value is
+     * unspecified until overwritten, and overwriting it reuses the spare's capacity.
+     */
+    std::string& slot(const std::string_view key) {
+        const auto it = lowerBound(key);
+        if (it != end() && it->first == key) {
+            return it->second;
+        }
+        return insert(it, key)->second;
+    }
+
+    size_type erase(const std::string_view key) {
+        const auto it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        std::rotate(it, it + 1, end());
+        --size_;
+        return 1;
+    }
+
+    bool operator==(const ExtensionMap& other) const {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    // Entries past size_ are spares
+    std::vector<value_type> entries_;
+    size_type size_ = 0;
+
+    iterator lowerBound(const std::string_view key) {
+        // Appending in key order, e.g. when copying another map, skips the search
+        if (size_ == 0 || entries_[size_ - 1].first < key) {
+            return end();
+        }
+        return std::lower_bound(begin(), end(), key,
+                                [](const value_type& entry, const std::string_view k) {
+                                    return std::string_view(entry.first) < k;
+                                });
+    }
+
+    // New entry for @p key before @p pos, with an unspecified value
+    iterator insert(const iterator pos, const std::string_view key) {
+        if (size_ == entries_.size()) {
+            ++size_;
+            return entries_.emplace(pos, std::string(key), std::string());
+        }
+        // Rotate the first spare into place; swapping strings does not allocate
+        const auto spare = end();
+        std::rotate(pos, spare, spare + 1);
+        ++size_;
+        pos->first.assign(key);
+        return pos;
+    }
+};
+
+} // namespace cef_cpp
+
+#endif
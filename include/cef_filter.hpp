@@ -0,0 +1,117 @@
+#ifndef CEF_CPP_CEF_FILTER_H
+#define CEF_CPP_CEF_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cef_cpp {
+
+class Event;
+class EventView;
+class Parser;
+
+/**
+ * @brief Exception thrown when a filter expression cannot be compiled
+ */
+class FilterException : public std::runtime_error {
+public:
+    FilterException(const std::string& message, const size_t offset)
+        : std::runtime_error("Invalid filter at offset " + std::to_string(offset) + ": " +
+                             message),
+          offset_(offset) {
+    }
+
+    // Byte offset in the expression at which the error was detected
+    size_t getOffset() const { return offset_; }
+
+private:
+    size_t offset_;
+};
+
+/**
+ * @brief Compiled predicate over CEF events
+ *
+ * Expressions compare fields with literals and combine the comparisons:
+ *
+ *     severity >= 2 and act != allowed
+ *     src in (10.0.0.0/8, 192.168.0.0/16) or dst startswith "172.16."
+ *     not (deviceVendor = Security and name in ("worm stopped", "worm started"))
+ *     exists(msg) && !(dpt in (80, 443))
+ *
+ * Fields are the header fields version, deviceVendor, deviceProduct, deviceVersion,
+ * deviceEventClassId, name and severity (the Event::Severity level), and extension
+ * keys by short or full name (src or sourceAddress). Literals are bare words or double
+ * quoted strings with \" and \\ escapes.
+ *
+ * - =, !=, <, <=, > and >= compare numerically when both sides are numbers and as
+ *   strings otherwise
+ * - `in` tests membership in a set of values; members written as CIDR blocks match
+ *   IPv4 or IPv6 addresses in the network
+ * - `startswith` tests for a prefix
+ * - `exists(field)` tests whether an extension is present
+ * - `and`/`&&`, `or`/`||` and `not`/`!` combine predicates; `not in` negates `in`
+ *
+ * A comparison with an absent field (or an unknown severity) is false, except for !=.
+ *
+ * Set as ParseOptions::filter, the parser evaluates the filter as soon as the header is
+ * split and rejects the line without scanning its extensions when the header fields
+ * alone decide the outcome. Rejected lines are reported as ParseErrorCode::Filtered
+ * and skipped by the bulk parsing functions.
+ */
+class Filter {
+public:
+    /**
+     * @param expression The filter expression to compile
+     * @throws FilterException if the expression is malformed
+     */
+    explicit Filter(std::string_view expression);
+
+    Filter(const Filter&);
+    Filter(Filter&&) noexcept;
+    Filter& operator=(const Filter&);
+    Filter& operator=(Filter&&) noexcept;
+    ~Filter();
+
+    bool matches(const Event& event) const;
+    bool matches(const EventView& view) const;
+
+    const std::string& getExpression() const { return expression_; }
+
+    // Extension keys the expression reads, by short name
+    const std::vector<std::string>& getExtensionKeys() const { return extension_keys_; }
+
+private:
+    friend class Parser;
+
+    enum class Match : uint8_t {
+        False,
+        True,
+        // Depends on extensions that are not scanned yet
+        Unknown
+    };
+
+    struct Node;
+    struct Input;
+    class Compiler;
+
+    std::string expression_;
+    std::vector<std::string> extension_keys_;
+    std::vector<Node> nodes_;
+    uint32_t root_ = 0;
+
+    /**
+     * @brief Evaluate against a view during parsing
+     *
+     * @param extensions_known Whether the view's extensions have been scanned yet
+     */
+    Match evaluate(const EventView& view, bool extensions_known) const;
+    Match evaluate(uint32_t node, const Input& input) const;
+};
+
+} // namespace cef_cpp
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef CEF_CPP_CEF_INGEST_SERVER_H
+#define CEF_CPP_CEF_INGEST_SERVER_H
+
+#include "cef_event.hpp"
+#include "cef_parser.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cef_cpp {
+
+namespace detail {
+template <typename T>
+class MpmcRingBuffer;
+}
+
+/**
+ * @brief Configuration of an IngestServer
+ */
+struct IngestOptions {
+    // Local IPv4 address to listen on
+    std::string bind_address = "0.0.0.0";
+
+    // Ports to listen on; 0 picks a free port, std::nullopt disables the protocol
+    std::optional<uint16_t> udp_port;
+    std::optional<uint16_t> tcp_port;
+
+    // Number of parser threads, 0 to use all hardware threads
+    size_t worker_count = 0;
+
+    // Messages buffered between the network thread and the parsers
+    size_t queue_capacity = 64 * 1024;
+
+    // Datagrams received per recvmmsg call
+    size_t udp_batch_size = 32;
+
+    // Longer datagrams are dropped and counted; longer TCP frames close the connection
+    size_t max_message_size = 64 * 1024;
+
+    /**
+     * @brief Backpressure policy when the queue is full
+     *
+     * If true, new messages are dropped and counted. If false, the network thread
+     * waits for the parsers, which throttles TCP senders through their receive window
+     * and leaves UDP datagrams to overflow the socket buffer.
+     */
+    bool drop_when_full = true;
+
+    ParseOptions parse_options{.syslog = true};
+};
+
+/**
+ * @brief Counters of an IngestServer, see IngestServer::getStats()
+ */
+struct IngestStats {
+    // Messages read from the network, including dropped ones
+    uint64_t received = 0;
+    uint64_t bytes_received = 0;
+    uint64_t parsed = 0;
+    uint64_t parse_errors = 0;
+    // Messages rejected by ParseOptions::filter
+    uint64_t filtered = 0;
+    // Messages discarded because the queue was full
+    uint64_t dropped = 0;
+    // Datagrams discarded for exceeding IngestOptions::max_message_size
+    uint64_t truncated = 0;
+    // Times the network thread waited for a free queue slot
+    uint64_t backpressure_waits = 0;
+    uint64_t connections_accepted = 0;
+    // TCP connections closed for oversized or malformed frames
+    uint64_t connections_rejected = 0;
+};
+
+/**
+ * @brief Receives CEF over UDP and TCP and parses it on a pool of worker threads
+ *
+ * A single network thread waits on all sockets with epoll. UDP datagrams are read in
+ * batches with recvmmsg, and TCP streams are split into syslog frames (octet-counted
+ * or newline-terminated, see extractSyslogFrame). Each message, or each line of a
+ * multi-line datagram, is pushed into a bounded lock-free queue that the workers
+ * drain with Parser::tryParse.
+ *
+ * The server listens from construction until stop() or destruction. The callbacks
+ * are called concurrently from the worker threads and must not throw. If the network
+ * thread fails, isReceiving() turns false and stop() rethrows the error.
+ */
+class IngestServer {
+public:
+    using EventCallback = std::function<void(Event&&)>;
+    using ErrorCallback = std::function<void(std::string_view message, const ParseError&)>;
+
+    /**
+     * @throws std::system_error if a socket cannot be set up
+     * @throws std::invalid_argument if no protocol is enabled
+     */
+    IngestServer(const IngestOptions& options,
+                 EventCallback on_event,
+                 ErrorCallback on_error = {});
+    ~IngestServer();
+
+    IngestServer(const IngestServer&) = delete;
+    IngestServer& operator=(const IngestServer&) = delete;
+
+    /**
+     * @brief Stop receiving, parse the queued messages and join all threads
+     *
+     * @throws std::system_error if the network thread failed before, e.g. in epoll_wait;
+     *         the threads are joined and the sockets closed all the same
+     */
+    void stop();
+
+    // False once stopped or after the network thread failed
+    bool isReceiving() const {
+        return receiving_.load(std::memory_order_acquire) &&
+               !network_failed_.load(std::memory_order_acquire);
+    }
+
+    // Bound ports, 0 if the protocol is disabled
+    uint16_t getUdpPort() const { return udp_port_; }
+    uint16_t getTcpPort() const { return tcp_port_; }
+
+    IngestStats getStats() const;
+
+private:
+    struct Connection;
+    struct Counters;
+    struct DatagramBuffers;
+
+    IngestOptions options_;
+    EventCallback on_event_;
+    ErrorCallback on_error_;
+
+    int epoll_fd_ = -1;
+    int stop_fd_ = -1;
+    int udp_fd_ = -1;
+    int tcp_fd_ = -1;
+    uint16_t udp_port_ = 0;
+    uint16_t tcp_port_ = 0;
+
+    std::unique_ptr<detail::MpmcRingBuffer<std::string>> queue_;
+    std::unique_ptr<Counters> counters_;
+
+    // recvmmsg buffers, reused across calls; only touched by the network thread
+    std::unique_ptr<DatagramBuffers> datagram_buffers_;
+
+    // Open TCP connections by file descriptor; only touched by the network thread
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+
+    // Bumped after pushes and pops; workers and a blocked producer wait on them
+    std::atomic<uint32_t> pushed_{0};
+    std::atomic<uint32_t> popped_{0};
+    std::atomic<bool> receiving_{true};
+    std::atomic<bool> stopped_{false};
+
+    // Set by the network thread before it exits on an error
+    std::exception_ptr network_error_;
+    std::atomic<bool> network_failed_{false};
+
+    std::thread network_thread_;
+    std::vector<std::thread> workers_;
+
+    void setupUdp();
+    void setupTcp();
+    void networkLoop();
+    void receiveDatagrams();
+    void acceptConnections();
+    bool readConnection(Connection& connection);
+    bool processFrames(Connection& connection, bool end_of_input);
+    void enqueue(std::string_view message);
+    void workerLoop();
+    void stopWorkers();
+    void closeSockets();
+};
+
+} // namespace cef_cpp
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef CEF_CPP_CEF_METRICS_H
+#define CEF_CPP_CEF_METRICS_H
+
+#include "cef_parser.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Set by the CEF_CPP_ENABLE_METRICS CMake option
+#ifndef CEF_CPP_METRICS
+#define CEF_CPP_METRICS 0
+#endif
+
+namespace cef_cpp {
+
+inline constexpr size_t kParseErrorCodeCount = static_cast<size_t>(ParseErrorCode::Filtered) + 1;
+
+/**
+ * @brief Histogram with power-of-two bucket bounds
+ *
+ * Bucket i counts values in (first_bound << (i - 1), first_bound << i]; the first
+ * bucket starts at 0 and the last one is unbounded.
+ */
+struct Histogram {
+    static constexpr size_t kBuckets = 16;
+
+    uint64_t first_bound = 1;
+    std::array<uint64_t, kBuckets> buckets{};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+
+    static constexpr size_t bucketFor(const uint64_t value, const uint64_t first_bound) {
+        if (value <= first_bound) {
+            return 0;
+        }
+        const auto bucket = static_cast<size_t>(std::bit_width((value - 1) / first_bound));
+        return bucket < kBuckets ? bucket : kBuckets - 1;
+    }
+
+    uint64_t getUpperBound(const size_t bucket) const { return first_bound << bucket; }
+};
+
+/**
+ * @brief Parser counters summed over all threads, see Metrics::snapshot()
+ */
+struct ParserMetrics {
+    // Lines handed to the parser, and their CEF payload bytes
+    uint64_t lines = 0;
+    uint64_t bytes = 0;
+    // Lines that produced an event
+    uint64_t events = 0;
+    // Rejected lines by ParseErrorCode
+    std::array<uint64_t, kParseErrorCodeCount> errors{};
+
+    // Extensions per event
+    Histogram extensions{.first_bound = 1};
+
+    // Stage latencies in nanoseconds: splitting and validating the header, tokenizing
+    // the extensions, and unescaping them into an Event
+    Histogram header_split{.first_bound = 32};
+    Histogram extension_tokenize{.first_bound = 32};
+    Histogram unescape{.first_bound = 32};
+
+    uint64_t getErrors(const ParseErrorCode code) const {
+        return errors[static_cast<size_t>(code)];
+    }
+
+    /**
+     * @brief Format in the Prometheus text exposition format
+     *
+     * @param prefix Prefix of the metric names
+     */
+    std::string toPrometheus(std::string_view prefix = "cef_parser") const;
+};
+
+/**
+ * @brief Opt-in parser instrumentation
+ *
+ * Built with CEF_CPP_ENABLE_METRICS, the parser counts lines, bytes, events and errors
+ * by kind, and records the extension count and stage latencies of every line. Each
+ * thread accumulates into its own counters without synchronization; snapshot() sums
+ * them. Without the option nothing is recorded and snapshots are empty.
+ */
+class Metrics {
+public:
+    static constexpr bool kEnabled = CEF_CPP_METRICS != 0;
+
+    /**
+     * @brief Sum the counters of all threads, including threads that have exited
+     */
+    static ParserMetrics snapshot();
+
+    /**
+     * @brief Make later snapshots count from now on
+     */
+    static void reset();
+};
+
+} // namespace cef_cpp
+
+#endif
@@ -2,13 +2,31 @@
 #define CEF_CPP_CEF_PARSER_H
 
 #include "cef_event.hpp"
+#include "cef_filter.hpp"
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace cef_cpp {
 
+class EventBatch;
+class ThreadPool;
+
+namespace detail {
+class StructuralIndex;
+}
+
 /**
  * @brief Exception thrown when CEF parsing fails
  */
@@ -19,22 +37,233 @@ public:
     }
 };
 
+/**
+ * @brief Reasons a line can fail to parse
+ */
+enum class ParseErrorCode : uint8_t {
+    EmptyLine,
+    MissingPrefix,
+    TooFewFields,
+    EmptyField,
+    InvalidVersion,
+    InvalidSeverity,
+    InvalidSyslogHeader,
+    // Rejected by ParseOptions::filter; skipped rather than reported by bulk parsing
+    Filtered
+};
+
+/**
+ * @brief Error returned by the non-throwing parse API
+ */
+struct ParseError {
+    ParseErrorCode code;
+    // Byte offset in the line at which the error was detected
+    size_t offset = 0;
+
+    std::string message() const;
+    static const char* codeToString(ParseErrorCode code);
+};
+
+/**
+ * @brief Error of a single line in a lenient batch
+ */
+struct LineError {
+    // 1-based number of the line within the batch
+    size_t line_number;
+    ParseError error;
+};
+
+/**
+ * @brief Either a parsed value or the ParseError explaining why parsing failed
+ */
+template <typename T>
+class ParseResult {
+public:
+    ParseResult(T value) : result_(std::move(value)) {}
+    ParseResult(const ParseError error) : result_(error) {}
+
+    bool hasValue() const { return std::holds_alternative<T>(result_); }
+    explicit operator bool() const { return hasValue(); }
+
+    // Accessing the value of a failed result throws ParseException
+    T& value() {
+        throwIfError();
+        return std::get<T>(result_);
+    }
+
+    const T& value() const {
+        throwIfError();
+        return std::get<T>(result_);
+    }
+
+    T& operator*() { return std::get<T>(result_); }
+    const T& operator*() const { return std::get<T>(result_); }
+    T* operator->() { return &std::get<T>(result_); }
+    const T* operator->() const { return &std::get<T>(result_); }
+
+    const ParseError& error() const { return std::get<ParseError>(result_); }
+
+private:
+    std::variant<T, ParseError> result_;
+
+    void throwIfError() const {
+        if (!hasValue()) {
+            throw ParseException(error().message());
+        }
+    }
+};
+
+/**
+ * @brief Options controlling how Parser builds events
+ */
+struct ParseOptions {
+    /**
+     * @brief Only index extensions while parsing and decode each value on first access
+     *
+     * Cheaper for wide events of which only a few extensions are read. The full map is
+     * built when Event::getExtensions() is called.
+     */
+    bool lazy_extensions = false;
+
+    /**
+     * @brief Accept CEF wrapped in syslog
+     *
+     * RFC 3164 and RFC 5424 headers are stripped and kept as event metadata, and
+     * StreamParser additionally accepts octet-counted frames (RFC 6587).
+     */
+    bool syslog = false;
+
+    /**
+     * @brief Keep only events matching this filter
+     *
+     * Evaluated right after the header is split, so events rejected on header fields
+     * never have their extensions scanned, and before any Event is built.
+     */
+    std::shared_ptr<const Filter> filter = nullptr;
+
+    /**
+     * @brief Build events with only these fields
+     *
+     * Extensions outside the projection are skipped without being unescaped or stored.
+     * The filter still sees every field.
+     */
+    std::shared_ptr<const Projection> projection = nullptr;
+};
+
 /**
  * @brief CEF (Common Event Format) Parser
  *
  * Parses CEF formatted log messages according to the CEF specification.
  * CEF Format: CEF:Version|Device Vendor|Device Product|Device Version|Device Event Class ID|Name|Severity|Extension
+ *
+ * The static functions are stateless and thread-safe. A Parser instance holds options
+ * and scratch space for parseInto(), and must not be used from several threads at once.
  */
 class Parser {
 public:
+    Parser() = default;
+
+    explicit Parser(ParseOptions options);
+
+    const ParseOptions& getOptions() const { return options_; }
+
+    /**
+     * @brief Parse a line into an existing event, as configured by the parser's options
+     *
+     * The parser reuses its extension index and @p event its strings and extension
+     * storage, so once both have grown to fit the input, parsing a line does not
+     * allocate. Device header fields are interned, which allocates only for new values.
+     *
+     * @code
+     * Parser parser;
+     * Event event;
+     * for (const std::string& line : lines) {
+     *     if (!parser.parseInto(line, event)) { ... }
+     * }
+     * @endcode
+     *
+     * @param line The line to parse
+     * @param event Event to overwrite; left unchanged if the line is rejected
+     * @return std::nullopt on success, otherwise the reason the line was rejected
+     */
+    std::optional<ParseError> parseInto(std::string_view line, Event& event);
+
     /**
      * @brief Parse a single CEF log line
      *
      * @param cef_line The CEF formatted string to parse
+     * @param options Parsing options
      * @return Parsed CEF Event object
      * @throws ParseException if the line cannot be parsed
      */
-    static Event parse(const std::string& cef_line);
+    static Event parse(const std::string& cef_line, const ParseOptions& options = {});
+
+    /**
+     * @brief Parse a single CEF log line without copying it
+     *
+     * The returned view refers into @p cef_line, which must outlive it. Fields are
+     * unescaped only when read.
+     *
+     * @param cef_line The CEF formatted string to parse
+     * @return Non-owning view of the parsed CEF event
+     * @throws ParseException if the line cannot be parsed
+     */
+    static EventView parseView(std::string_view cef_line);
+
+    /**
+     * @brief Parse a single CEF log line without throwing
+     *
+     * Malformed lines are reported through the result rather than an exception, which
+     * keeps rejecting junk input as cheap as parsing valid lines.
+     *
+     * @param cef_line The CEF formatted string to parse
+     * @param options Parsing options
+     * @return Parsed CEF Event object or the reason the line was rejected
+     */
+    static ParseResult<Event> tryParse(std::string_view cef_line,
+                                       const ParseOptions& options = {});
+
+    /**
+     * @brief Parse a single CEF log line into a view without throwing
+     *
+     * @param cef_line The CEF formatted string to parse; must outlive the view
+     * @param resource Memory resource for the view's extension index
+     * @return Non-owning view of the parsed CEF event or the reason it was rejected
+     */
+    static ParseResult<EventView> tryParseView(
+        std::string_view cef_line,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Parse a syslog line carrying a CEF payload into a view without throwing
+     *
+     * The syslog header is split off without copying and exposed through
+     * EventView::getSyslogHeader(); lines without a header are parsed as plain CEF.
+     *
+     * @param line The syslog line to parse; must outlive the view
+     * @param resource Memory resource for the view's extension index
+     * @return Non-owning view of the parsed CEF event or the reason it was rejected;
+     *         error offsets refer to @p line
+     */
+    static ParseResult<EventView> tryParseSyslog(
+        std::string_view line,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Parse a line into a view as configured by @p options, without throwing
+     *
+     * Honors ParseOptions::syslog and ParseOptions::filter; lazy_extensions only
+     * applies when the view is copied into an Event.
+     *
+     * @param line The line to parse; must outlive the view
+     * @param options Parsing options
+     * @param resource Memory resource for the view's extension index
+     * @return Non-owning view of the parsed CEF event or the reason it was rejected
+     */
+    static ParseResult<EventView> tryParseView(
+        std::string_view line,
+        const ParseOptions& options,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /**
      * @brief Parse multiple CEF log lines
@@ -45,15 +274,157 @@ public:
      */
     static std::vector<Event> parseMultiple(const std::vector<std::string>& cef_lines);
 
+    /**
+     * @brief Parse multiple CEF log lines, skipping malformed ones
+     *
+     * @param cef_lines Vector of CEF formatted strings
+     * @param errors Receives the line number and error of every skipped line
+     * @param options Parsing options
+     * @return Vector of the successfully parsed CEF Event objects
+     */
+    static std::vector<Event> parseMultiple(const std::vector<std::string>& cef_lines,
+                                            std::vector<LineError>& errors,
+                                            const ParseOptions& options = {});
+
+    /**
+     * @brief Parse multiple CEF log lines in parallel
+     *
+     * Lines are parsed in chunks that idle threads of @p pool steal from busy ones,
+     * and each result is written to its own pre-sized slot, so the output keeps the
+     * input order without any synchronization between lines.
+     *
+     * @param cef_lines Vector of CEF formatted strings
+     * @param pool Thread pool to parse on
+     * @param options Parsing options
+     * @return Vector of parsed CEF Event objects, in input order
+     * @throws ParseException for the first line (in input order) that cannot be parsed
+     */
+    static std::vector<Event> parseMultiple(const std::vector<std::string>& cef_lines,
+                                            ThreadPool& pool,
+                                            const ParseOptions& options = {});
+
+    /**
+     * @brief Parse multiple CEF log lines in parallel, skipping malformed ones
+     *
+     * @param cef_lines Vector of CEF formatted strings
+     * @param errors Receives the line number and error of every skipped line, in order
+     * @param pool Thread pool to parse on
+     * @param options Parsing options
+     * @return Vector of the successfully parsed CEF Event objects, in input order
+     */
+    static std::vector<Event> parseMultiple(const std::vector<std::string>& cef_lines,
+                                            std::vector<LineError>& errors,
+                                            ThreadPool& pool,
+                                            const ParseOptions& options = {});
+
+    /**
+     * @brief Parse multiple CEF log lines into an arena-backed batch
+     *
+     * Unlike parseMultiple, the events of the batch share one allocation region that
+     * is released in a single step. Include cef_event_batch.hpp to use the result.
+     *
+     * @param cef_lines Vector of CEF formatted strings
+     * @param options Parsing options; lines rejected by the filter are skipped
+     * @return Batch of parsed events, in input order
+     * @throws ParseException if any line cannot be parsed
+     */
+    static EventBatch parseBatch(const std::vector<std::string>& cef_lines,
+                                 const ParseOptions& options = {});
+
+    /**
+     * @brief Parse multiple CEF log lines into an arena-backed batch, skipping
+     *        malformed ones
+     *
+     * @param cef_lines Vector of CEF formatted strings
+     * @param errors Receives the line number and error of every malformed line
+     * @param options Parsing options; lines rejected by the filter are skipped without
+     *                an error
+     * @return Batch of the successfully parsed events, in input order
+     */
+    static EventBatch parseBatch(const std::vector<std::string>& cef_lines,
+                                 std::vector<LineError>& errors,
+                                 const ParseOptions& options = {});
+
     /**
      * @brief Parse CEF log from a string containing multiple lines
      *
+     * Lines end at "\n" or "\r\n"; blank lines are skipped. The string is scanned in
+     * place, and strings of a megabyte or more are parsed in parallel on a thread
+     * pool that is started on first use and shared by all such calls; concurrent calls
+     * take turns on it.
+     *
      * @param cef_log Multi-line string containing CEF events
-     * @return Vector of parsed CEF Event objects
+     * @return Vector of parsed CEF Event objects, in input order
      * @throws ParseException if any line cannot be parsed
      */
     static std::vector<Event> parseFromString(const std::string& cef_log);
 
+    /**
+     * @brief Parse CEF log from a multi-line string, skipping malformed lines
+     *
+     * @param cef_log Multi-line string containing CEF events
+     * @param errors Receives the line number and error of every skipped line, in order;
+     *               blank lines count towards the line numbers
+     * @param options Parsing options
+     * @return Vector of the successfully parsed CEF Event objects, in input order
+     */
+    static std::vector<Event> parseFromString(const std::string& cef_log,
+                                              std::vector<LineError>& errors,
+                                              const ParseOptions& options = {});
+
+    /**
+     * @brief Parse CEF log from a multi-line string in parallel
+     *
+     * The string is split into chunks of whole lines without copying them, and the
+     * chunks are parsed on @p pool.
+     *
+     * @param cef_log Multi-line string containing CEF events
+     * @param pool Thread pool to parse on
+     * @param options Parsing options
+     * @return Vector of parsed CEF Event objects, in input order
+     * @throws ParseException for the first line that cannot be parsed
+     */
+    static std::vector<Event> parseFromString(const std::string& cef_log,
+                                              ThreadPool& pool,
+                                              const ParseOptions& options = {});
+
+    /**
+     * @brief Parse CEF log from a multi-line string in parallel, skipping malformed
+     *        lines
+     *
+     * @param cef_log Multi-line string containing CEF events
+     * @param errors Receives the line number and error of every skipped line, in order
+     * @param pool Thread pool to parse on
+     * @param options Parsing options
+     * @return Vector of the successfully parsed CEF Event objects, in input order
+     */
+    static std::vector<Event> parseFromString(const std::string& cef_log,
+                                              std::vector<LineError>& errors,
+                                              ThreadPool& pool,
+                                              const ParseOptions& options = {});
+
+    /**
+     * @brief Parse a CEF log file in parallel
+     *
+     * The file is memory-mapped and split into byte ranges aligned to line boundaries,
+     * one per thread. Lines are parsed straight from the mapping without read() copies.
+     * Blank lines and lines rejected by ParseOptions::filter are skipped, and "\r\n"
+     * line endings are accepted.
+     *
+     * @param path Path of the CEF log file
+     * @param callback Receives every parsed event; it is called concurrently from the
+     *                 worker threads, in file order within each thread's range
+     * @param thread_count Number of worker threads, 0 to use all hardware threads
+     * @param options Parsing options
+     * @return Number of parsed events
+     * @throws ParseException if any line cannot be parsed
+     * @throws std::system_error if the file cannot be opened or mapped
+     */
+    static size_t parseFile(const std::string& path,
+                            const std::function<void(Event&&)>& callback,
+                            size_t thread_count = 0,
+                            const ParseOptions& options = {});
+
     /**
      * @brief Validate if a string appears to be a valid CEF format
      *
@@ -64,12 +435,44 @@ public:
 
 private:
     // Helper methods for parsing
-    static std::vector<std::string> splitHeader(const std::string& header_part);
+    static size_t splitHeader(detail::StructuralIndex& index,
+                              std::array<std::string_view, 7>& fields,
+                              std::string_view& extension_part);
+    static bool parseHeaderInt(std::string_view field, int& value);
+    // Parse one CEF line and record it in the metrics
+    static ParseResult<EventView> parseCef(std::string_view cef_line,
+                                           std::pmr::memory_resource* resource,
+                                           const Filter* filter);
+    static std::optional<ParseError> parseCefInto(std::string_view cef_line,
+                                                  const Filter* filter, EventView& event);
+    static std::optional<ParseError> scanCef(std::string_view cef_line,
+                                             const Filter* filter, EventView& event);
+    static ParseResult<EventView> parseSyslog(std::string_view line,
+                                              std::pmr::memory_resource* resource,
+                                              const Filter* filter);
+    static std::optional<ParseError> parseSyslogInto(std::string_view line,
+                                                     const Filter* filter,
+                                                     EventView& event);
     static std::unordered_map<std::string, std::string> parseExtensions(
-        const std::string& extension_part);
-    static std::string unescapeString(const std::string& str);
+        const std::string& extension_part,
+        const Projection* projection = nullptr);
+    static std::string unescapeString(std::string_view str);
     static std::string escapeString(const std::string& str);
-    static void validateHeaderFieldCount(const std::vector<std::string>& fields);
+    static std::vector<Event> parseParallel(const std::vector<std::string>& cef_lines,
+                                            std::vector<LineError>& errors,
+                                            ThreadPool& pool,
+                                            const ParseOptions& options);
+    static std::vector<Event> parseText(std::string_view text,
+                                        std::vector<LineError>& errors,
+                                        ThreadPool* pool,
+                                        const ParseOptions& options);
+    static std::optional<ParseError> validateHeaderFields(
+        std::string_view cef_line,
+        const std::array<std::string_view, 7>& fields);
+
+    ParseOptions options_;
+    // Index of the last line parsed by parseInto(), kept for its capacity
+    EventView view_;
 };
 
 } // namespace cef_cpp
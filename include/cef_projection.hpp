@@ -0,0 +1,59 @@
+#ifndef CEF_CPP_CEF_PROJECTION_H
+#define CEF_CPP_CEF_PROJECTION_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cef_cpp {
+
+/**
+ * @brief Subset of fields to keep when building events
+ *
+ * Set as ParseOptions::projection, the parser copies only these fields into each Event:
+ * other extensions are neither unescaped nor stored, and other header fields are left
+ * empty instead of being interned or copied. Version, severity and the syslog metadata are always
+ * kept.
+ */
+class Projection {
+public:
+    enum class HeaderField : uint8_t {
+        DeviceVendor,
+        DeviceProduct,
+        DeviceVersion,
+        DeviceEventClassId,
+        Name
+    };
+
+    static constexpr std::initializer_list<HeaderField> kAllHeaderFields = {
+        HeaderField::DeviceVendor, HeaderField::DeviceProduct, HeaderField::DeviceVersion,
+        HeaderField::DeviceEventClassId, HeaderField::Name};
+
+    /**
+     * @param extension_keys Extension keys to keep, by short or full name (src or
+     *                       sourceAddress)
+     * @param header_fields Header fields to keep
+     */
+    explicit Projection(
+        const std::vector<std::string>& extension_keys,
+        std::initializer_list<HeaderField> header_fields = kAllHeaderFields);
+
+    bool containsHeaderField(const HeaderField field) const {
+        return header_fields_ >> static_cast<unsigned>(field) & 1;
+    }
+
+    bool containsExtension(std::string_view key) const;
+
+    // Projected extension keys by short name, sorted
+    const std::vector<std::string>& getExtensionKeys() const { return extension_keys_; }
+
+private:
+    uint8_t header_fields_ = 0;
+    std::vector<std::string> extension_keys_;
+};
+
+} // namespace cef_cpp
+
+#endif
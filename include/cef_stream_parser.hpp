@@ -0,0 +1,165 @@
+#ifndef CEF_CPP_CEF_STREAM_PARSER_H
+#define CEF_CPP_CEF_STREAM_PARSER_H
+
+#include "cef_event.hpp"
+#include "cef_parser.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace cef_cpp {
+
+/**
+ * @brief Incremental CEF parser over an std::istream or a file descriptor
+ *
+ * Input is read in fixed-size chunks into a single buffer, so memory stays bounded by
+ * the chunk size and the longest line regardless of the input size. Lines may be
+ * terminated by "\n" or "\r\n"; blank lines are skipped. With ParseOptions::syslog,
+ * syslog headers are stripped and octet-counted frames (RFC 6587) are accepted as well,
+ * so the parser can read a syslog TCP stream directly.
+ *
+ * @code
+ * std::ifstream file("archive.cef");
+ * StreamParser parser(file);
+ * for (const Event& event : parser) { ... }
+ * @endcode
+ */
+class StreamParser {
+public:
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+    static constexpr size_t kDefaultMaxLineLength = 1024 * 1024;
+
+    /**
+     * @brief Input iterator yielding the remaining events of a StreamParser
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Event;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Event*;
+        using reference = const Event&;
+
+        Iterator() = default;
+
+        explicit Iterator(StreamParser* parser) : parser_(parser) { ++*this; }
+
+        reference operator*() const { return *current_; }
+        pointer operator->() const { return &*current_; }
+
+        Iterator& operator++() {
+            current_ = parser_->next();
+            if (!current_) {
+                parser_ = nullptr;
+            }
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(const Iterator& other) const { return parser_ == other.parser_; }
+
+    private:
+        StreamParser* parser_ = nullptr;
+        std::optional<Event> current_;
+    };
+
+    /**
+     * @brief Read from a stream; the stream must outlive the parser
+     */
+    explicit StreamParser(std::istream& input,
+                          const ParseOptions& options = {},
+                          size_t chunk_size = kDefaultChunkSize);
+
+    /**
+     * @brief Read from a file descriptor; the descriptor is not closed by the parser
+     */
+    explicit StreamParser(int fd,
+                          const ParseOptions& options = {},
+                          size_t chunk_size = kDefaultChunkSize);
+
+    /**
+     * @brief Parse the next non-blank line
+     *
+     * @return Parsed CEF Event, or std::nullopt at the end of the input
+     * @throws ParseException if the line cannot be parsed or exceeds the maximum length
+     * @throws std::system_error if reading from the file descriptor fails
+     */
+    std::optional<Event> next();
+
+    /**
+     * @brief Parse the next non-blank line without copying it
+     *
+     * Lines rejected by ParseOptions::filter are skipped.
+     *
+     * The view refers into the internal buffer and is invalidated by the next read.
+     *
+     * @return View of the parsed CEF event, or std::nullopt at the end of the input
+     * @throws ParseException if the line cannot be parsed or exceeds the maximum length
+     */
+    std::optional<EventView> nextView();
+
+    /**
+     * @brief Read the next non-blank line or syslog frame, without its terminator
+     *
+     * @param line Receives a view into the internal buffer, valid until the next read
+     * @return false at the end of the input
+     */
+    bool nextLine(std::string_view& line);
+
+    /**
+     * @brief Parse all remaining events and pass each one to @p callback
+     *
+     * @return Number of events parsed
+     */
+    template <typename Callback>
+    size_t forEach(Callback&& callback) {
+        size_t count = 0;
+        while (auto event = next()) {
+            callback(std::move(*event));
+            ++count;
+        }
+        return count;
+    }
+
+    Iterator begin() { return Iterator(this); }
+    Iterator end() { return Iterator(); }
+
+    // Physical line number of the last line read (1-based, blank lines included), or
+    // the number of the last syslog frame read
+    size_t getLineNumber() const { return line_number_; }
+
+    void setMaxLineLength(const size_t max_line_length) {
+        max_line_length_ = max_line_length;
+    }
+
+    size_t getMaxLineLength() const { return max_line_length_; }
+
+private:
+    std::istream* stream_ = nullptr;
+    int fd_ = -1;
+    ParseOptions options_;
+
+    // Unconsumed input lives in buffer_[begin_, end_); scan_ marks how far that range
+    // has already been searched for a newline
+    std::vector<char> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    size_t scan_ = 0;
+    bool eof_ = false;
+
+    size_t line_number_ = 0;
+    size_t max_line_length_ = kDefaultMaxLineLength;
+
+    bool nextFrame(std::string_view& frame);
+    void fill();
+    size_t read(char* data, size_t size);
+};
+
+} // namespace cef_cpp
+
+#endif
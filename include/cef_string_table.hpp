@@ -0,0 +1,98 @@
+#ifndef CEF_CPP_CEF_STRING_TABLE_H
+#define CEF_CPP_CEF_STRING_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace cef_cpp {
+
+/**
+ * @brief Thread-safe table of interned strings
+ *
+ * Header fields such as the device vendor, product and version repeat across millions
+ * of events. Interning stores each distinct value once and lets events refer to it by
+ * pointer. Interned strings are never freed, so the table grows with the number of
+ * distinct values, not with the number of events; only fields drawn from a small set,
+ * such as those identifying the sending device, should be interned.
+ *
+ * A table can be given a byte budget. Once it is spent, tryIntern() declines new values
+ * and callers keep their own copy instead, so senders that vary their header fields
+ * cannot grow the table without limit. The global table is bounded this way.
+ *
+ * The table is split into shards, each guarded by its own reader-writer lock, so
+ * lookups of values already present proceed in parallel.
+ */
+class StringTable {
+public:
+    static constexpr size_t kUnbounded = std::numeric_limits<size_t>::max();
+
+    // Budget of the global table, counting each string's characters and overhead
+    static constexpr size_t kGlobalMaxBytes = size_t{16} << 20;
+
+    explicit StringTable(const size_t max_bytes = kUnbounded) : max_bytes_(max_bytes) {}
+
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    /**
+     * @brief Table shared by all events; it is never destroyed
+     */
+    static StringTable& global();
+
+    /**
+     * @brief Return the interned copy of @p str, adding it if needed
+     *
+     * @return Reference that stays valid for the lifetime of the table
+     * @throws std::length_error if @p str is new and the table's budget is spent
+     */
+    const std::string& intern(std::string_view str);
+
+    /**
+     * @brief Return the interned copy of @p str, adding it if the budget allows
+     *
+     * @return Pointer that stays valid for the lifetime of the table, or nullptr if
+     *         @p str is new and adding it would exceed the budget
+     */
+    const std::string* tryIntern(std::string_view str);
+
+    // Number of distinct strings in the table
+    size_t size() const;
+
+    // Bytes charged against the budget
+    size_t getByteSize() const { return bytes_.load(std::memory_order_relaxed); }
+
+    static const std::string& empty() { return kEmpty; }
+
+private:
+    static constexpr size_t kShardCount = 16;
+    static inline const std::string kEmpty;
+
+    struct Hash {
+        using is_transparent = void;
+
+        size_t operator()(const std::string_view str) const {
+            return std::hash<std::string_view>()(str);
+        }
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        // Node-based, so references stay valid when the set rehashes
+        std::unordered_set<std::string, Hash, std::equal_to<>> strings;
+    };
+
+    std::array<Shard, kShardCount> shards_;
+    const size_t max_bytes_;
+    std::atomic<size_t> bytes_{0};
+};
+
+} // namespace cef_cpp
+
+#endif
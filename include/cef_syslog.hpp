@@ -0,0 +1,87 @@
+#ifndef CEF_CPP_CEF_SYSLOG_H
+#define CEF_CPP_CEF_SYSLOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace cef_cpp {
+
+/**
+ * @brief Syslog header that preceded a CEF payload
+ *
+ * All fields are views into the parsed line. RFC 5424 nil values ("-") are reported as
+ * empty views.
+ */
+struct SyslogHeader {
+    enum class Format : uint8_t {
+        // The line started with "CEF:" directly
+        None,
+        Rfc3164,
+        Rfc5424
+    };
+
+    Format format = Format::None;
+    // PRI value (facility * 8 + severity), -1 if the header had none
+    int priority = -1;
+    std::string_view timestamp;
+    std::string_view hostname;
+    // RFC 5424 APP-NAME or the RFC 3164 tag without its PID and colon
+    std::string_view app_name;
+    // RFC 5424 only
+    std::string_view proc_id;
+    std::string_view msg_id;
+    std::string_view structured_data;
+
+    int getFacility() const { return priority < 0 ? -1 : priority >> 3; }
+    int getSeverity() const { return priority < 0 ? -1 : priority & 7; }
+};
+
+/**
+ * @brief Split a syslog line into its header and the CEF payload
+ *
+ * Recognizes RFC 5424 headers, RFC 3164 headers (with a "Mmm dd hh:mm:ss" or a single
+ * token timestamp, and an optional tag) and lines without a header. Nothing is copied.
+ *
+ * @param line Syslog line
+ * @param header Receives the header fields
+ * @param payload Receives the rest of the line, starting at "CEF:"
+ * @return false if no CEF payload follows a well-formed header
+ */
+bool splitSyslogLine(std::string_view line, SyslogHeader& header, std::string_view& payload);
+
+/**
+ * @brief Outcome of extracting a frame from a syslog transport buffer
+ */
+enum class FrameStatus : uint8_t {
+    Complete,
+    // More input is needed
+    Incomplete,
+    // The buffer does not start with a valid frame
+    Invalid
+};
+
+/**
+ * @brief Extract the next syslog frame from the start of @p buffer
+ *
+ * Handles both TCP framings of RFC 6587, detected per frame: octet counting
+ * ("LEN SP MSG") when the frame starts with digits followed by a space and the "<" of
+ * the message's PRI, and newline-terminated frames otherwise, with an optional "\r"
+ * before the newline. Lines that start with a timestamp rather than a PRI are thus
+ * newline-terminated frames. Line breaks between frames are skipped.
+ *
+ * @param buffer Received bytes not yet consumed
+ * @param end_of_input True if no more bytes will follow, so an unterminated line is
+ *                     the last frame
+ * @param frame Receives the message of a complete frame, a view into @p buffer
+ * @param consumed Receives the number of bytes to drop from the buffer, including the
+ *                 skipped line breaks if the status is Incomplete
+ */
+FrameStatus extractSyslogFrame(std::string_view buffer,
+                               bool end_of_input,
+                               std::string_view& frame,
+                               size_t& consumed);
+
+} // namespace cef_cpp
+
+#endif
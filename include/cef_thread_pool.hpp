@@ -0,0 +1,72 @@
+#ifndef CEF_CPP_CEF_THREAD_POOL_H
+#define CEF_CPP_CEF_THREAD_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cef_cpp {
+
+/**
+ * @brief Fixed-size thread pool running data-parallel loops with work stealing
+ *
+ * parallelFor splits an index range into chunks and deals them out to the workers
+ * and the calling thread. A participant that runs out of chunks steals from the
+ * others' queues, which keeps all threads busy when chunk costs are very uneven
+ * (e.g. batches mixing short and very long CEF lines).
+ *
+ * One loop runs at a time; concurrent parallelFor calls are serialized.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param thread_count Number of worker threads, 0 to use all hardware threads; the
+     *                     thread calling parallelFor participates as well
+     */
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads participating in a loop, including the caller
+    size_t getConcurrency() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Call @p body(begin, end) for consecutive chunks covering [0, count)
+     *
+     * Blocks until every chunk has run. If a chunk throws, the remaining chunks are
+     * still processed and the first exception is rethrown to the caller.
+     *
+     * @param count Number of indices
+     * @param grain_size Maximum number of indices per chunk
+     * @param body Called concurrently from several threads
+     */
+    void parallelFor(size_t count,
+                     size_t grain_size,
+                     const std::function<void(size_t, size_t)>& body);
+
+private:
+    struct Job;
+
+    std::vector<std::thread> workers_;
+
+    // Serializes parallelFor calls
+    std::mutex job_mutex_;
+
+    // Workers sleep on generation_ and pick up job_ whenever it changes
+    std::atomic<Job*> job_{nullptr};
+    std::atomic<uint64_t> generation_{0};
+    std::atomic<bool> stop_{false};
+
+    void workerLoop(size_t participant);
+    static void runJob(Job& job, size_t participant);
+};
+
+} // namespace cef_cpp
+
+#endif
@@ -0,0 +1,162 @@
+#include "cef_aggregator.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+using namespace cef_cpp;
+
+namespace {
+
+// Marks an absent extension in a key, distinct from any value length
+constexpr uint32_t kAbsent = UINT32_MAX;
+
+void appendRaw(std::string& key, const void* data, const size_t size) {
+    key.append(static_cast<const char*>(data), size);
+}
+
+// Values are length-prefixed, so different splits of the same characters differ
+void appendValue(std::string& key, const std::string_view value) {
+    const auto size = static_cast<uint32_t>(value.size());
+    appendRaw(key, &size, sizeof(size));
+    key += value;
+}
+
+int64_t baseEventCount(const Event& event) {
+    const auto count = event.getInteger(ExtensionKey::BaseEventCount);
+    return count && *count > 0 ? *count : 1;
+}
+
+} // namespace
+
+Aggregator::Aggregator(Callback callback, AggregatorOptions options)
+    : callback_(std::move(callback)), options_(std::move(options)),
+      shard_capacity_(std::max<size_t>((options_.max_keys + kShardCount - 1) / kShardCount,
+                                       1)) {
+}
+
+Aggregator::~Aggregator() = default;
+
+void Aggregator::buildKey(const Event& event, std::string& key) const {
+    using HeaderField = Projection::HeaderField;
+    const Projection& projection = *options_.key;
+    key.clear();
+
+    // By value: device fields may be stored inline once the string table is full
+    const auto header = [&](const HeaderField field, const std::string& value) {
+        if (projection.containsHeaderField(field)) {
+            appendValue(key, value);
+        }
+    };
+    header(HeaderField::DeviceVendor, event.getDeviceVendor());
+    header(HeaderField::DeviceProduct, event.getDeviceProduct());
+    header(HeaderField::DeviceVersion, event.getDeviceVersion());
+    header(HeaderField::DeviceEventClassId, event.getDeviceEventClassId());
+    header(HeaderField::Name, event.getName());
+
+    if (projection.getExtensionKeys().empty()) {
+        return;
+    }
+    const ExtensionMap& extensions = event.getExtensions();
+    for (const std::string& name : projection.getExtensionKeys()) {
+        if (const auto it = extensions.find(name); it != extensions.end()) {
+            appendValue(key, it->second);
+        } else {
+            appendRaw(key, &kAbsent, sizeof(kAbsent));
+        }
+    }
+}
+
+void Aggregator::add(const Event& event, const Timestamp now) {
+    thread_local std::string key;
+    buildKey(event, key);
+    const int64_t count = baseEventCount(event);
+
+    Shard& shard = shards_[(std::hash<std::string_view>()(key) >> 7) % kShardCount];
+    Window closed;
+    {
+        const std::lock_guard lock(shard.mutex);
+        std::list<Window>::iterator window;
+        if (const auto it = shard.index.find(key); it != shard.index.end()) {
+            window = it->second;
+            if (now < window->first_seen + options_.window) {
+                window->count += count;
+                window->last_seen = std::max(window->last_seen, now);
+                return;
+            }
+            // Expired without a flush; the key reopens its window
+            closed.event = std::move(window->event);
+        } else if (shard.windows.size() >= shard_capacity_) {
+            // Close the oldest window early and reuse its node
+            window = shard.windows.begin();
+            shard.index.erase(window->key);
+            closed.event = std::move(window->event);
+            window->key.assign(key);
+            shard.index.emplace(window->key, window);
+        } else {
+            window = shard.windows.emplace(shard.windows.end());
+            window->key.assign(key);
+            shard.index.emplace(window->key, window);
+        }
+
+        closed.count = std::exchange(window->count, count);
+        closed.first_seen = std::exchange(window->first_seen, now);
+        closed.last_seen = std::exchange(window->last_seen, now);
+        window->event = event;
+        shard.windows.splice(shard.windows.end(), shard.windows, window);
+    }
+
+    if (closed.count > 0) {
+        emit(closed);
+    }
+}
+
+template <typename Predicate>
+size_t Aggregator::closeWindows(Predicate expired) {
+    size_t emitted = 0;
+    std::vector<Window> closed;
+    for (Shard& shard : shards_) {
+        {
+            const std::lock_guard lock(shard.mutex);
+            while (!shard.windows.empty() && expired(shard.windows.front())) {
+                shard.index.erase(shard.windows.front().key);
+                closed.push_back(std::move(shard.windows.front()));
+                shard.windows.pop_front();
+            }
+        }
+
+        for (Window& window : closed) {
+            emit(window);
+        }
+        emitted += closed.size();
+        closed.clear();
+    }
+    return emitted;
+}
+
+size_t Aggregator::flush(const Timestamp now) {
+    return closeWindows([&](const Window& window) {
+        return window.first_seen + options_.window <= now;
+    });
+}
+
+size_t Aggregator::flushAll() {
+    return closeWindows([](const Window&) { return true; });
+}
+
+size_t Aggregator::size() const {
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+        const std::lock_guard lock(shard.mutex);
+        size += shard.windows.size();
+    }
+    return size;
+}
+
+void Aggregator::emit(Window& window) const {
+    Event& summary = window.event;
+    summary.setExtension("cnt", std::to_string(window.count));
+    summary.setExtension("start", std::to_string(window.first_seen.time_since_epoch().count()));
+    summary.setExtension("end", std::to_string(window.last_seen.time_since_epoch().count()));
+    callback_(std::move(summary));
+}
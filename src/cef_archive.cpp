@@ -0,0 +1,345 @@
+#include "cef_archive.hpp"
+#include "cef_mapped_file.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+using namespace cef_cpp;
+
+namespace {
+
+constexpr std::string_view kMagic("CEFA\x01\0\0\0", 8);
+constexpr uint8_t kCodecNone = 0;
+
+void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void appendString(std::string& out, const std::string_view str) {
+    appendVarint(out, str.size());
+    out += str;
+}
+
+uint64_t zigzag(const int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(const uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Bounds-checked decoding of a range of the archive; errors report offsets from base
+struct Cursor {
+    const char* pos;
+    const char* end;
+    const char* base;
+
+    [[noreturn]] void fail(const char* message) const {
+        throw ArchiveException(message, static_cast<size_t>(pos - base));
+    }
+
+    bool empty() const { return pos == end; }
+
+    uint8_t byte() {
+        if (pos == end) {
+            fail("truncated");
+        }
+        return static_cast<uint8_t>(*pos++);
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = this->byte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        fail("varint too long");
+    }
+
+    std::string_view bytes(const uint64_t size) {
+        if (size > static_cast<uint64_t>(end - pos)) {
+            fail("truncated");
+        }
+        const std::string_view result(pos, size);
+        pos += size;
+        return result;
+    }
+
+    std::string_view string() { return bytes(varint()); }
+
+    uint32_t index(const size_t dictionary_size) {
+        const uint64_t index = varint();
+        if (index >= dictionary_size) {
+            fail("dictionary index out of range");
+        }
+        return static_cast<uint32_t>(index);
+    }
+
+    std::string_view rest() const { return {pos, static_cast<size_t>(end - pos)}; }
+};
+
+} // namespace
+
+ArchiveWriter::ArchiveWriter(std::ostream& output, const size_t block_size)
+    : output_(output), block_size_(std::max<size_t>(block_size, 1)) {
+    output_.write(kMagic.data(), static_cast<std::streamsize>(kMagic.size()));
+}
+
+ArchiveWriter::~ArchiveWriter() {
+    try {
+        writeBlock();
+    } catch (...) {
+        // The stream reports errors through its state unless it was set to throw
+    }
+}
+
+void ArchiveWriter::write(const Event& event) {
+    record_.clear();
+    appendVarint(record_, zigzag(event.getVersion()));
+    record_.push_back(static_cast<char>(static_cast<int>(event.getSeverity()) + 1));
+    appendVarint(record_, indexOf(event.getDeviceVendor()));
+    appendVarint(record_, indexOf(event.getDeviceProduct()));
+    appendVarint(record_, indexOf(event.getDeviceVersion()));
+    appendVarint(record_, indexOf(event.getDeviceEventClassId()));
+    appendVarint(record_, indexOf(event.getName()));
+    appendVarint(record_, zigzag(event.getSyslogPriority()));
+    appendString(record_, event.getSyslogTimestamp());
+    appendVarint(record_, indexOf(event.getSyslogHostname()));
+    appendVarint(record_, indexOf(event.getSyslogAppName()));
+
+    const ExtensionMap& extensions = event.getExtensions();
+    appendVarint(record_, extensions.size());
+    for (const auto& [key, value] : extensions) {
+        appendVarint(record_, indexOf(key));
+        appendString(record_, value);
+    }
+
+    appendString(records_, record_);
+    ++event_count_;
+    if (++block_events_ == block_size_) {
+        writeBlock();
+    }
+}
+
+void ArchiveWriter::write(const std::span<const Event> events) {
+    for (const Event& event : events) {
+        write(event);
+    }
+}
+
+void ArchiveWriter::flush() {
+    writeBlock();
+    output_.flush();
+}
+
+uint32_t ArchiveWriter::indexOf(const std::string_view str) {
+    if (const auto it = dictionary_index_.find(str); it != dictionary_index_.end()) {
+        return it->second;
+    }
+    const auto index = static_cast<uint32_t>(dictionary_.size());
+    // Map keys are nodes, so views of them stay valid while the map grows
+    dictionary_.push_back(dictionary_index_.emplace(str, index).first->first);
+    return index;
+}
+
+void ArchiveWriter::writeBlock() {
+    if (block_events_ == 0) {
+        return;
+    }
+
+    std::string dictionary;
+    appendVarint(dictionary, dictionary_.size());
+    for (const std::string_view entry : dictionary_) {
+        appendString(dictionary, entry);
+    }
+
+    std::string header;
+    header.push_back(static_cast<char>(kCodecNone));
+    appendVarint(header, block_events_);
+    appendVarint(header, dictionary.size() + records_.size());
+
+    output_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    output_.write(dictionary.data(), static_cast<std::streamsize>(dictionary.size()));
+    output_.write(records_.data(), static_cast<std::streamsize>(records_.size()));
+
+    dictionary_.clear();
+    dictionary_index_.clear();
+    records_.clear();
+    block_events_ = 0;
+}
+
+std::optional<std::string_view> ArchivedEvent::getExtension(const std::string_view key) const {
+    std::optional<std::string_view> result;
+    const char* pos = extensions_.data();
+    std::string_view current_key;
+    std::string_view value;
+    for (size_t i = 0; i < extension_count_ && !result; ++i) {
+        readExtension(pos, current_key, value);
+        if (current_key == key) {
+            result = value;
+        }
+    }
+    return result;
+}
+
+void ArchivedEvent::readExtension(const char*& pos, std::string_view& key,
+                                  std::string_view& value) const {
+    Cursor cursor{pos, extensions_.data() + extensions_.size(), reader_->data_.data()};
+    key = dictionary_[cursor.index(reader_->dictionary_.size())];
+    value = cursor.string();
+    pos = cursor.pos;
+}
+
+Event ArchivedEvent::toEvent() const {
+    Event event;
+    event.version_ = version_;
+    event.severity_ = severity_;
+    event.device_vendor_.assign(reader_->intern(device_vendor_),
+                                dictionary_[device_vendor_]);
+    event.device_product_.assign(reader_->intern(device_product_),
+                                 dictionary_[device_product_]);
+    event.device_version_.assign(reader_->intern(device_version_),
+                                 dictionary_[device_version_]);
+    event.device_event_class_id_.assign(reader_->intern(device_event_class_id_),
+                                        dictionary_[device_event_class_id_]);
+    event.name_ = dictionary_[name_];
+
+    event.syslog_priority_ = syslog_priority_;
+    event.syslog_timestamp_ = syslog_timestamp_;
+    event.syslog_hostname_ = dictionary_[syslog_hostname_];
+    event.syslog_app_name_ = dictionary_[syslog_app_name_];
+
+    // Keys arrive in order, so each insertion appends
+    event.extensions_.reserve(extension_count_);
+    forEachExtension([&](const std::string_view key, const std::string_view value) {
+        event.storeExtension(key, std::string(value));
+    });
+    return event;
+}
+
+ArchiveReader::ArchiveReader(const std::string& path)
+    : ArchiveReader({}, std::make_unique<detail::MappedFile>(path)) {
+}
+
+ArchiveReader ArchiveReader::fromBuffer(const std::string_view data) {
+    return ArchiveReader(data, nullptr);
+}
+
+ArchiveReader::ArchiveReader(const std::string_view data,
+                             std::unique_ptr<detail::MappedFile> file)
+    : file_(std::move(file)), data_(file_ ? file_->data() : data) {
+    if (!data_.starts_with(kMagic.substr(0, 4))) {
+        throw ArchiveException("missing magic", 0);
+    }
+    if (data_.size() < kMagic.size() || data_[4] != kMagic[4]) {
+        throw ArchiveException("unsupported format version", 4);
+    }
+    offset_ = kMagic.size();
+}
+
+ArchiveReader::ArchiveReader(ArchiveReader&&) noexcept = default;
+ArchiveReader& ArchiveReader::operator=(ArchiveReader&&) noexcept = default;
+ArchiveReader::~ArchiveReader() = default;
+
+bool ArchiveReader::readBlock() {
+    Cursor cursor{data_.data() + offset_, data_.data() + data_.size(), data_.data()};
+    if (cursor.empty()) {
+        return false;
+    }
+
+    if (cursor.byte() != kCodecNone) {
+        --cursor.pos;
+        cursor.fail("unsupported block codec");
+    }
+    const uint64_t events = cursor.varint();
+    const std::string_view payload = cursor.bytes(cursor.varint());
+    offset_ = static_cast<size_t>(cursor.pos - data_.data());
+
+    Cursor block{payload.data(), payload.data() + payload.size(), data_.data()};
+    const uint64_t entries = block.varint();
+    // Each entry takes at least its length byte
+    if (entries > payload.size()) {
+        block.fail("dictionary larger than its block");
+    }
+    dictionary_.clear();
+    dictionary_.reserve(entries);
+    for (uint64_t i = 0; i < entries; ++i) {
+        dictionary_.push_back(block.string());
+    }
+    interned_.assign(entries, std::nullopt);
+
+    records_ = block.rest();
+    block_events_ = events;
+    return true;
+}
+
+std::optional<ArchivedEvent> ArchiveReader::nextView() {
+    while (block_events_ == 0) {
+        if (!records_.empty()) {
+            Cursor{records_.data(), records_.data(), data_.data()}.fail(
+                "trailing data in block");
+        }
+        if (!readBlock()) {
+            return std::nullopt;
+        }
+    }
+
+    Cursor cursor{records_.data(), records_.data() + records_.size(), data_.data()};
+    const std::string_view record = cursor.string();
+    records_ = cursor.rest();
+    --block_events_;
+
+    Cursor fields{record.data(), record.data() + record.size(), data_.data()};
+    const size_t entries = dictionary_.size();
+    ArchivedEvent event;
+    event.reader_ = this;
+    event.dictionary_ = dictionary_.data();
+    event.version_ = static_cast<int>(unzigzag(fields.varint()));
+    const uint8_t severity = fields.byte();
+    if (severity > static_cast<int>(Event::Severity::VeryHigh) + 1) {
+        --fields.pos;
+        fields.fail("invalid severity");
+    }
+    event.severity_ = static_cast<Event::Severity>(severity - 1);
+    event.device_vendor_ = fields.index(entries);
+    event.device_product_ = fields.index(entries);
+    event.device_version_ = fields.index(entries);
+    event.device_event_class_id_ = fields.index(entries);
+    event.name_ = fields.index(entries);
+    event.syslog_priority_ = static_cast<int>(unzigzag(fields.varint()));
+    event.syslog_timestamp_ = fields.string();
+    event.syslog_hostname_ = fields.index(entries);
+    event.syslog_app_name_ = fields.index(entries);
+
+    const uint64_t extension_count = fields.varint();
+    event.extensions_ = fields.rest();
+    // Each extension takes at least a key index and a length byte
+    if (extension_count > event.extensions_.size() / 2) {
+        fields.fail("extension count exceeds record");
+    }
+    event.extension_count_ = extension_count;
+    return event;
+}
+
+std::optional<Event> ArchiveReader::next() {
+    const auto view = nextView();
+    if (!view) {
+        return std::nullopt;
+    }
+    return view->toEvent();
+}
+
+const std::string* ArchiveReader::intern(const uint32_t index) const {
+    std::optional<const std::string*>& interned = interned_[index];
+    if (!interned) {
+        interned = StringTable::global().tryIntern(dictionary_[index]);
+    }
+    return *interned;
+}
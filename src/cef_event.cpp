@@ -1,101 +1,428 @@
 #include "cef_event.hpp"
+#include "cef_metrics_recorder.hpp"
+#include "cef_scanner.hpp"
 
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
 
 using namespace cef_cpp;
 
-void Event::setSeverity(const int severity) {
+Event::Severity Event::toSeverity(const int severity) {
     switch (severity) {
     case 0:
-        severity_ = Severity::Low;
-        break;
+        return Severity::Low;
     case 1:
-        severity_ = Severity::Medium;
-        break;
+        return Severity::Medium;
     case 2:
-        severity_ = Severity::High;
-        break;
+        return Severity::High;
     case 3:
-        severity_ = Severity::VeryHigh;
-        break;
+        return Severity::VeryHigh;
     default:
-        severity_ = Severity::Unknown;
+        return Severity::Unknown;
+    }
+}
+
+namespace {
+
+std::optional<int64_t> toInteger(const std::string_view str) {
+    int64_t value = 0;
+    const auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (ec != std::errc() || end != str.data() + str.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<double> toFloat(const std::string_view str) {
+    double value = 0;
+    const auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (ec != std::errc() || end != str.data() + str.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+template <typename T>
+std::optional<T> getTyped(const T* value) {
+    return value != nullptr ? std::optional<T>(*value) : std::nullopt;
+}
+
+// Guards lazy decoding; events share a few locks rather than carrying one each
+std::mutex& lazyMutex(const void* event) {
+    static std::array<std::mutex, 64> mutexes;
+    return mutexes[(reinterpret_cast<uintptr_t>(event) / alignof(std::max_align_t)) %
+                   mutexes.size()];
+}
+
+} // namespace
+
+Event::Event(const Event& other) {
+    *this = other;
+}
+
+Event::Event(Event&& other) noexcept
+    : version_(other.version_),
+      severity_(other.severity_),
+      device_vendor_(std::move(other.device_vendor_)),
+      device_product_(std::move(other.device_product_)),
+      device_version_(std::move(other.device_version_)),
+      device_event_class_id_(std::move(other.device_event_class_id_)),
+      name_(std::move(other.name_)),
+      syslog_priority_(other.syslog_priority_),
+      syslog_timestamp_(std::move(other.syslog_timestamp_)),
+      syslog_hostname_(std::move(other.syslog_hostname_)),
+      syslog_app_name_(std::move(other.syslog_app_name_)),
+      extensions_(std::move(other.extensions_)),
+      typed_extensions_(std::move(other.typed_extensions_)),
+      lazy_raw_(std::move(other.lazy_raw_)),
+      lazy_extensions_(std::move(other.lazy_extensions_)),
+      lazy_pending_(other.lazy_pending_.exchange(false, std::memory_order_relaxed)) {
+}
+
+Event& Event::operator=(const Event& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    // Another thread may be decoding a lazy value of other
+    const auto lock = other.lockLazy();
+    version_ = other.version_;
+    severity_ = other.severity_;
+    device_vendor_ = other.device_vendor_;
+    device_product_ = other.device_product_;
+    device_version_ = other.device_version_;
+    device_event_class_id_ = other.device_event_class_id_;
+    name_ = other.name_;
+    syslog_priority_ = other.syslog_priority_;
+    syslog_timestamp_ = other.syslog_timestamp_;
+    syslog_hostname_ = other.syslog_hostname_;
+    syslog_app_name_ = other.syslog_app_name_;
+    extensions_ = other.extensions_;
+    typed_extensions_ = other.typed_extensions_;
+    lazy_raw_ = other.lazy_raw_;
+    lazy_extensions_ = other.lazy_extensions_;
+    lazy_pending_.store(other.lazy_pending_.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    return *this;
+}
+
+Event& Event::operator=(Event&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    version_ = other.version_;
+    severity_ = other.severity_;
+    device_vendor_ = std::move(other.device_vendor_);
+    device_product_ = std::move(other.device_product_);
+    device_version_ = std::move(other.device_version_);
+    device_event_class_id_ = std::move(other.device_event_class_id_);
+    name_ = std::move(other.name_);
+    syslog_priority_ = other.syslog_priority_;
+    syslog_timestamp_ = std::move(other.syslog_timestamp_);
+    syslog_hostname_ = std::move(other.syslog_hostname_);
+    syslog_app_name_ = std::move(other.syslog_app_name_);
+    extensions_ = std::move(other.extensions_);
+    typed_extensions_ = std::move(other.typed_extensions_);
+    lazy_raw_ = std::move(other.lazy_raw_);
+    lazy_extensions_ = std::move(other.lazy_extensions_);
+    lazy_pending_.store(other.lazy_pending_.exchange(false, std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    return *this;
+}
+
+std::unique_lock<std::mutex> Event::lockLazy() const {
+    if (!lazy_pending_.load(std::memory_order_acquire)) {
+        return {};
+    }
+    return std::unique_lock(lazyMutex(this));
+}
+
+void Event::setExtension(const std::string_view key, const std::string& value) {
+    storeExtension(key, value);
+}
+
+const std::string& Event::storeExtension(const std::string_view key,
+                                         std::string value) const {
+    const std::string& stored = extensions_.insert_or_assign(key, std::move(value))->second;
+    convertExtension(key, stored);
+    return stored;
+}
+
+const std::string& Event::storeRawExtension(const std::string_view key,
+                                            const std::string_view raw) const {
+    // Unescape into the slot so a recycled event reuses the string of a cleared value
+    std::string& stored = extensions_.slot(key);
+    stored.clear();
+    detail::appendUnescaped(raw, stored);
+    convertExtension(key, stored);
+    return stored;
+}
+
+void Event::convertExtension(const std::string_view key, const std::string& value) const {
+    const auto id = findExtensionKey(key);
+    if (!id) {
+        return;
+    }
+    std::erase_if(typed_extensions_,
+                  [&](const TypedExtension& typed) { return typed.key == *id; });
+
+    std::optional<TypedValue> typed;
+    switch (getExtensionKeyInfo(*id).type) {
+    case ExtensionType::String:
+        break;
+    case ExtensionType::Integer:
+    case ExtensionType::Long:
+        typed = toInteger(value);
+        break;
+    case ExtensionType::Float:
+        typed = toFloat(value);
         break;
+    case ExtensionType::Address:
+        typed = IpAddress::parse(value);
+        break;
+    case ExtensionType::Timestamp:
+        typed = parseTimestamp(value);
+        break;
+    }
+    if (typed) {
+        typed_extensions_.push_back({*id, std::move(*typed)});
+    }
+}
+
+const Event::TypedValue* Event::findTypedExtension(const ExtensionKey key) const {
+    for (const auto& typed : typed_extensions_) {
+        if (typed.key == key) {
+            return &typed.value;
+        }
+    }
+
+    // A lazy value is converted when it is decoded
+    const std::string_view name = getExtensionKeyInfo(key).key;
+    if (!lazy_extensions_.empty() && !extensions_.contains(name) &&
+        findExtension(name) != nullptr) {
+        for (const auto& typed : typed_extensions_) {
+            if (typed.key == key) {
+                return &typed.value;
+            }
+        }
     }
+    return nullptr;
 }
 
-void Event::setExtension(const std::string& key, const std::string& value) {
-    extensions_[key] = value;
+// The typed getters copy the value out before the lazy lock is released
+std::optional<int64_t> Event::getInteger(const ExtensionKey key) const {
+    const auto lock = lockLazy();
+    return getTyped(std::get_if<int64_t>(findTypedExtension(key)));
 }
 
-std::optional<std::string> Event::getExtension(const std::string& key) const {
-    if (const auto it = extensions_.find(key); it != extensions_.end()) {
-        return it->second;
+std::optional<double> Event::getFloat(const ExtensionKey key) const {
+    const auto lock = lockLazy();
+    return getTyped(std::get_if<double>(findTypedExtension(key)));
+}
+
+std::optional<IpAddress> Event::getAddress(const ExtensionKey key) const {
+    const auto lock = lockLazy();
+    return getTyped(std::get_if<IpAddress>(findTypedExtension(key)));
+}
+
+std::optional<Timestamp> Event::getTimestamp(const ExtensionKey key) const {
+    const auto lock = lockLazy();
+    return getTyped(std::get_if<Timestamp>(findTypedExtension(key)));
+}
+
+std::optional<std::string> Event::getExtension(const std::string_view key) const {
+    const auto lock = lockLazy();
+    if (const std::string* value = findExtension(key)) {
+        return *value;
     }
     return std::nullopt;
 }
 
-std::optional<int> Event::getSourcePort() const {
-    if (const auto port_str = getExtension("spt"); port_str.has_value()) {
-        try {
-            return std::stoi(port_str.value());
-        } catch (const std::exception&) {
-            return std::nullopt;
+const std::string* Event::findExtension(const std::string_view key) const {
+    if (const auto it = extensions_.find(key); it != extensions_.end()) {
+        return &it->second;
+    }
+
+    // Decode a pending lazy value on first access; the last occurrence of a key wins
+    for (auto it = lazy_extensions_.rbegin(); it != lazy_extensions_.rend(); ++it) {
+        if (std::string_view(lazy_raw_).substr(it->key_offset, it->key_length) == key) {
+            const auto value =
+                std::string_view(lazy_raw_).substr(it->value_offset, it->value_length);
+            return &storeRawExtension(key, value);
         }
     }
-    return std::nullopt;
+    return nullptr;
 }
 
-std::optional<int> Event::getDestinationPort() const {
-    if (const auto port_str = getExtension("dpt"); port_str.has_value()) {
-        try {
-            return std::stoi(port_str.value());
-        } catch (const std::exception&) {
-            return std::nullopt;
+void Event::setLazyExtensions(
+    const std::string_view extension_part,
+    const std::span<const std::pair<std::string_view, std::string_view>> extensions) {
+    lazy_raw_ = extension_part;
+    lazy_extensions_.clear();
+    lazy_extensions_.reserve(extensions.size());
+
+    for (const auto& [key, value] : extensions) {
+        lazy_extensions_.push_back({
+            static_cast<size_t>(key.data() - extension_part.data()),
+            key.size(),
+            static_cast<size_t>(value.data() - extension_part.data()),
+            value.size()
+        });
+    }
+    lazy_pending_.store(!lazy_extensions_.empty(), std::memory_order_relaxed);
+}
+
+void Event::materializeExtensions() const {
+    const auto lock = lockLazy();
+    if (lazy_extensions_.empty()) {
+        return;
+    }
+
+    // Values already decoded or set explicitly take precedence over raw ones
+    const std::string_view raw = lazy_raw_;
+    for (auto it = lazy_extensions_.rbegin(); it != lazy_extensions_.rend(); ++it) {
+        const auto key = raw.substr(it->key_offset, it->key_length);
+        if (!extensions_.contains(key)) {
+            storeRawExtension(key, raw.substr(it->value_offset, it->value_length));
         }
     }
-    return std::nullopt;
+
+    lazy_raw_.clear();
+    lazy_raw_.shrink_to_fit();
+    lazy_extensions_.clear();
+    lazy_extensions_.shrink_to_fit();
+    lazy_pending_.store(false, std::memory_order_release);
+}
+
+namespace {
+
+std::optional<int> toPort(const std::optional<int64_t> port) {
+    if (!port || *port < 0 || *port > 65535) {
+        return std::nullopt;
+    }
+    return static_cast<int>(*port);
+}
+
+} // namespace
+
+std::optional<int> Event::getSourcePort() const {
+    return toPort(getInteger(ExtensionKey::SourcePort));
+}
+
+std::optional<int> Event::getDestinationPort() const {
+    return toPort(getInteger(ExtensionKey::DestinationPort));
 }
 
 bool Event::isValid() const {
     // Check that all required header fields are present
     return version_ > 0 &&
-           !device_vendor_.empty() &&
-           !device_product_.empty() &&
-           !device_version_.empty() &&
-           !device_event_class_id_.empty() &&
+           !device_vendor_.get().empty() &&
+           !device_product_.get().empty() &&
+           !device_version_.get().empty() &&
+           !device_event_class_id_.get().empty() &&
            !name_.empty() &&
            severity_ != Severity::Unknown;
 }
 
-std::string Event::toString() const {
-    std::ostringstream oss;
+namespace {
 
-    // TODO add escaping
+// Longest decimal form of an int, sign included
+constexpr size_t kMaxIntLength = 11;
 
-    // Build header
-    oss << "CEF:" << version_
-        << "|" << device_vendor_
-        << "|" << device_product_
-        << "|" << device_version_
-        << "|" << device_event_class_id_
-        << "|" << name_
-        << "|" << static_cast<int>(severity_);
+size_t intLength(const int value) {
+    char buffer[kMaxIntLength];
+    return std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer;
+}
+
+char* writeString(const std::string_view str, char* out) {
+    return std::copy(str.begin(), str.end(), out);
+}
+
+} // namespace
+
+size_t Event::getSerializedSize() const {
+    materializeExtensions();
+
+    // "CEF:" and six pipes
+    size_t size = 4 + 6 + intLength(version_) + intLength(static_cast<int>(severity_));
+    for (const std::string* field :
+         {&device_vendor_.get(), &device_product_.get(), &device_version_.get(),
+          &device_event_class_id_.get(), &name_}) {
+        size += detail::escapedSize(*field, detail::HeaderEscapeClass);
+    }
 
-    // Add extensions
     if (!extensions_.empty()) {
-        oss << "|";
-        bool first = true;
+        // A pipe, one '=' per pair and the separating spaces
+        size += 1 + 2 * extensions_.size() - 1;
         for (const auto& [key, value] : extensions_) {
-            if (!first) {
-                oss << " ";
-            }
-            oss << key << "=" << value;
-            first = false;
+            size += key.size() + detail::escapedSize(value, detail::ExtensionEscapeClass);
         }
     }
+    return size;
+}
 
-    return oss.str();
+char* Event::write(char* out) const {
+    out = writeString("CEF:", out);
+    out = std::to_chars(out, out + kMaxIntLength, version_).ptr;
+    for (const std::string* field :
+         {&device_vendor_.get(), &device_product_.get(), &device_version_.get(),
+          &device_event_class_id_.get(), &name_}) {
+        *out++ = '|';
+        out = detail::writeEscaped(*field, detail::HeaderEscapeClass, out);
+    }
+    *out++ = '|';
+    out = std::to_chars(out, out + kMaxIntLength, static_cast<int>(severity_)).ptr;
+
+    bool first = true;
+    for (const auto& [key, value] : extensions_) {
+        *out++ = first ? '|' : ' ';
+        out = writeString(key, out);
+        *out++ = '=';
+        out = detail::writeEscaped(value, detail::ExtensionEscapeClass, out);
+        first = false;
+    }
+    return out;
+}
+
+std::string Event::toString() const {
+    std::string result;
+    appendTo(result);
+    return result;
+}
+
+void Event::appendTo(std::string& out) const {
+    const size_t offset = out.size();
+    out.resize(offset + getSerializedSize());
+    write(out.data() + offset);
+}
+
+size_t Event::writeTo(const std::span<char> buffer) const {
+    const size_t size = getSerializedSize();
+    if (buffer.size() < size) {
+        return 0;
+    }
+    write(buffer.data());
+    return size;
+}
+
+void Event::appendTo(const std::span<const Event> events, std::string& out) {
+    size_t size = 0;
+    for (const Event& event : events) {
+        size += event.getSerializedSize() + 1;
+    }
+
+    const size_t offset = out.size();
+    out.resize(offset + size);
+
+    char* pos = out.data() + offset;
+    for (const Event& event : events) {
+        pos = event.write(pos);
+        *pos++ = '\n';
+    }
 }
 
 std::string Event::severityToString(const Severity severity) {
@@ -114,3 +441,125 @@ std::string Event::severityToString(const Severity severity) {
         return "Invalid";
     }
 }
+
+std::string EventView::getDeviceVendor() const {
+    return detail::unescape(device_vendor_);
+}
+
+std::string EventView::getDeviceProduct() const {
+    return detail::unescape(device_product_);
+}
+
+std::string EventView::getDeviceVersion() const {
+    return detail::unescape(device_version_);
+}
+
+std::string EventView::getDeviceEventClassId() const {
+    return detail::unescape(device_event_class_id_);
+}
+
+std::string EventView::getName() const {
+    return detail::unescape(name_);
+}
+
+std::optional<std::string> EventView::getExtension(const std::string_view key) const {
+    if (const auto raw = getRawExtension(key); raw.has_value()) {
+        return detail::unescape(raw.value());
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> EventView::getRawExtension(const std::string_view key) const {
+    for (auto it = extensions_.rbegin(); it != extensions_.rend(); ++it) {
+        if (it->first == key) {
+            return it->second;
+        }
+    }
+    return std::nullopt;
+}
+
+// Repeated values are looked up without allocating, unescaping through a per-thread
+// buffer when needed
+void Event::DeviceField::assignRaw(const std::string_view raw) {
+    if (raw.find('\\') == std::string_view::npos) {
+        assign(raw);
+        return;
+    }
+    thread_local std::string unescaped;
+    unescaped.clear();
+    detail::appendUnescaped(raw, unescaped);
+    assign(unescaped);
+}
+
+Event EventView::toEvent(const bool lazy_extensions,
+                         const Projection* projection) const {
+    Event event;
+    copyTo(event, lazy_extensions, projection);
+    return event;
+}
+
+void EventView::copyTo(Event& event, const bool lazy_extensions,
+                       const Projection* projection) const {
+    using HeaderField = Projection::HeaderField;
+    const auto header = [&](const HeaderField field, Event::DeviceField& target,
+                            const std::string_view raw) {
+        if (projection == nullptr || projection->containsHeaderField(field)) {
+            target.assignRaw(raw);
+        } else {
+            target.assign({});
+        }
+    };
+
+    event.version_ = version_;
+    header(HeaderField::DeviceVendor, event.device_vendor_, device_vendor_);
+    header(HeaderField::DeviceProduct, event.device_product_, device_product_);
+    header(HeaderField::DeviceVersion, event.device_version_, device_version_);
+    header(HeaderField::DeviceEventClassId, event.device_event_class_id_,
+           device_event_class_id_);
+    // The name is copied into the event's own string, which keeps its capacity
+    event.name_.clear();
+    if (projection == nullptr || projection->containsHeaderField(HeaderField::Name)) {
+        detail::appendUnescaped(name_, event.name_);
+    }
+    event.severity_ = severity_;
+
+    if (syslog_header_.format != SyslogHeader::Format::None) {
+        event.syslog_priority_ = syslog_header_.priority;
+        event.syslog_timestamp_.assign(syslog_header_.timestamp);
+        event.syslog_hostname_.assign(syslog_header_.hostname);
+        event.syslog_app_name_.assign(syslog_header_.app_name);
+    } else {
+        event.syslog_priority_ = -1;
+        event.syslog_timestamp_.clear();
+        event.syslog_hostname_.clear();
+        event.syslog_app_name_.clear();
+    }
+
+    // Clearing keeps the capacity of a recycled event
+    event.extensions_.clear();
+    event.typed_extensions_.clear();
+    event.lazy_raw_.clear();
+    event.lazy_extensions_.clear();
+    event.lazy_pending_.store(false, std::memory_order_relaxed);
+
+    if (projection != nullptr) {
+        detail::StageTimer timer(detail::Stage::Unescape);
+        for (const auto& [key, value] : extensions_) {
+            if (projection->containsExtension(key)) {
+                event.storeRawExtension(key, value);
+            }
+        }
+        return;
+    }
+
+    if (lazy_extensions) {
+        event.setLazyExtensions(extension_part_, extensions_);
+        return;
+    }
+
+    detail::StageTimer timer(detail::Stage::Unescape);
+    event.extensions_.reserve(extensions_.size());
+    for (const auto& [key, value] : extensions_) {
+        event.storeRawExtension(key, value);
+    }
+}
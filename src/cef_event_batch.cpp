@@ -0,0 +1,76 @@
+#include "cef_event_batch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+using namespace cef_cpp;
+
+EventBatch::EventBatch(const size_t initial_arena_size, std::pmr::memory_resource* upstream)
+    : initial_arena_size_(std::max<size_t>(initial_arena_size, 1)),
+      upstream_(upstream),
+      arena_(std::make_unique<std::pmr::monotonic_buffer_resource>(initial_arena_size_,
+                                                                   upstream_)),
+      events_(arena_.get()) {
+}
+
+EventBatch& EventBatch::operator=(EventBatch&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    // Polymorphic allocators do not propagate on move assignment, so assigning events_
+    // would keep it on the old arena. Move-constructing takes over the allocator of
+    // other, and the old views are destroyed before the old arena is freed.
+    std::destroy_at(&events_);
+    std::construct_at(&events_, std::move(other.events_));
+    arena_ = std::move(other.arena_);
+    return *this;
+}
+
+ParseResult<size_t> EventBatch::tryAdd(const std::string_view cef_line,
+                                       const ParseOptions& options) {
+    if (!arena_) {
+        clear();
+    }
+
+    // The copy keeps the views valid independently of the caller's buffer
+    char* copy = static_cast<char*>(arena_->allocate(cef_line.size(), 1));
+    if (!cef_line.empty()) {
+        std::memcpy(copy, cef_line.data(), cef_line.size());
+    }
+
+    auto view =
+        Parser::tryParseView(std::string_view(copy, cef_line.size()), options, arena_.get());
+    if (!view) {
+        return view.error();
+    }
+
+    events_.push_back(std::move(*view));
+    return events_.size() - 1;
+}
+
+const EventView& EventBatch::add(const std::string_view cef_line,
+                                 const ParseOptions& options) {
+    return events_[tryAdd(cef_line, options).value()];
+}
+
+void EventBatch::reserve(const size_t events) {
+    if (!arena_) {
+        clear();
+    }
+    events_.reserve(events);
+}
+
+void EventBatch::clear() {
+    if (!arena_) {
+        // Moved from: events_ may still refer to the arena that moved away
+        arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>(initial_arena_size_,
+                                                                       upstream_);
+    }
+
+    // Give up the vector's arena storage before releasing the arena itself
+    std::destroy_at(&events_);
+    std::construct_at(&events_, arena_.get());
+    arena_->release();
+}
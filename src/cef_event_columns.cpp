@@ -0,0 +1,379 @@
+#include "cef_event_columns.hpp"
+#include "cef_scanner.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+using namespace cef_cpp;
+
+namespace {
+
+// Fits the extension index of lines with up to 256 extensions without allocating
+constexpr size_t view_buffer_size = 8 * 1024;
+
+// Offsets are int32 as in the Arrow utf8 type
+void checkOffset(const size_t offset) {
+    if (offset > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::length_error("String column exceeds 2 GiB");
+    }
+}
+
+void appendBit(std::vector<uint8_t>& bitmap, const size_t index, const bool value) {
+    if (index % 8 == 0) {
+        bitmap.push_back(0);
+    }
+    bitmap.back() |= static_cast<uint8_t>(value) << (index % 8);
+}
+
+} // namespace
+
+void StringColumn::append(const std::string_view value) {
+    data_.append(value);
+    finishRow(true);
+}
+
+void StringColumn::appendEscaped(const std::string_view raw) {
+    detail::appendUnescaped(raw, data_);
+    finishRow(true);
+}
+
+void StringColumn::appendNull() {
+    finishRow(false);
+}
+
+void StringColumn::clear() {
+    offsets_.assign(1, 0);
+    data_.clear();
+    validity_.clear();
+    null_count_ = 0;
+}
+
+void StringColumn::finishRow(const bool valid) {
+    checkOffset(data_.size());
+    appendBit(validity_, size(), valid);
+    offsets_.push_back(static_cast<int32_t>(data_.size()));
+    null_count_ += !valid;
+}
+
+void DictionaryColumn::append(const std::string_view value) {
+    // Keep the load factor at or below one half
+    if (dictionary_.size() * 2 >= slots_.size()) {
+        grow();
+    }
+
+    const size_t mask = slots_.size() - 1;
+    size_t slot = std::hash<std::string_view>()(value) & mask;
+    for (;; slot = (slot + 1) & mask) {
+        const int32_t index = slots_[slot];
+        if (index < 0) {
+            slots_[slot] = static_cast<int32_t>(dictionary_.size());
+            indices_.push_back(slots_[slot]);
+            dictionary_.append(value);
+            return;
+        }
+        if (dictionary_[index] == value) {
+            indices_.push_back(index);
+            return;
+        }
+    }
+}
+
+void DictionaryColumn::grow() {
+    slots_.assign(std::max<size_t>(slots_.size() * 2, 16), -1);
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = 0; i < dictionary_.size(); ++i) {
+        size_t slot = std::hash<std::string_view>()(dictionary_[i]) & mask;
+        while (slots_[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = static_cast<int32_t>(i);
+    }
+}
+
+void DictionaryColumn::appendEscaped(const std::string_view raw) {
+    if (raw.find('\\') == std::string_view::npos) {
+        append(raw);
+        return;
+    }
+    scratch_.clear();
+    detail::appendUnescaped(raw, scratch_);
+    append(scratch_);
+}
+
+void DictionaryColumn::clear() {
+    indices_.clear();
+    dictionary_.clear();
+    std::fill(slots_.begin(), slots_.end(), -1);
+}
+
+EventColumns::EventColumns(std::vector<std::string> extension_keys)
+    : view_buffer_(std::make_unique<std::byte[]>(view_buffer_size)),
+      view_resource_(std::make_unique<std::pmr::monotonic_buffer_resource>(
+          view_buffer_.get(), view_buffer_size)) {
+    // Duplicate keys get a single column
+    for (std::string& key : extension_keys) {
+        if (std::find(extension_keys_.begin(), extension_keys_.end(), key) ==
+            extension_keys_.end()) {
+            extension_keys_.push_back(std::move(key));
+        }
+    }
+    for (size_t i = 0; i < extension_keys_.size(); ++i) {
+        extension_index_.emplace(extension_keys_[i], i);
+    }
+    extensions_.resize(extension_keys_.size());
+    row_values_.resize(extension_keys_.size());
+    row_present_.resize(extension_keys_.size());
+}
+
+ParseResult<size_t> EventColumns::tryAppend(const std::string_view cef_line,
+                                            const ParseOptions& options) {
+    view_resource_->release();
+    const auto view = Parser::tryParseView(cef_line, options, view_resource_.get());
+    if (!view) {
+        return view.error();
+    }
+
+    versions_.push_back(view->getVersion());
+    header_[0].appendEscaped(view->getRawDeviceVendor());
+    header_[1].appendEscaped(view->getRawDeviceProduct());
+    header_[2].appendEscaped(view->getRawDeviceVersion());
+    header_[3].appendEscaped(view->getRawDeviceEventClassId());
+    header_[4].appendEscaped(view->getRawName());
+    appendSeverity(view->getSeverity());
+
+    if (!extensions_.empty()) {
+        // One pass over the line's extensions; later duplicates overwrite earlier ones
+        std::fill(row_present_.begin(), row_present_.end(), false);
+        for (const auto& [key, value] : view->getRawExtensions()) {
+            const auto it = extension_index_.find(key);
+            if (it != extension_index_.end()) {
+                row_values_[it->second] = value;
+                row_present_[it->second] = true;
+            }
+        }
+        for (size_t i = 0; i < extensions_.size(); ++i) {
+            if (row_present_[i]) {
+                extensions_[i].appendEscaped(row_values_[i]);
+            } else {
+                extensions_[i].appendNull();
+            }
+        }
+    }
+    return size() - 1;
+}
+
+void EventColumns::append(const Event& event) {
+    versions_.push_back(event.getVersion());
+    header_[0].append(event.getDeviceVendor());
+    header_[1].append(event.getDeviceProduct());
+    header_[2].append(event.getDeviceVersion());
+    header_[3].append(event.getDeviceEventClassId());
+    header_[4].append(event.getName());
+    appendSeverity(event.getSeverity());
+
+    const ExtensionMap& extensions = event.getExtensions();
+    for (size_t i = 0; i < extensions_.size(); ++i) {
+        const auto it = extensions.find(extension_keys_[i]);
+        if (it != extensions.end()) {
+            extensions_[i].append(it->second);
+        } else {
+            extensions_[i].appendNull();
+        }
+    }
+}
+
+void EventColumns::reserve(const size_t rows) {
+    versions_.reserve(rows);
+    severities_.reserve(rows);
+    severity_validity_.reserve((rows + 7) / 8);
+}
+
+void EventColumns::clear() {
+    versions_.clear();
+    for (DictionaryColumn& column : header_) {
+        column.clear();
+    }
+    severities_.clear();
+    severity_validity_.clear();
+    severity_null_count_ = 0;
+    for (StringColumn& column : extensions_) {
+        column.clear();
+    }
+}
+
+const StringColumn* EventColumns::getExtension(const std::string_view key) const {
+    const auto it = extension_index_.find(key);
+    return it != extension_index_.end() ? &extensions_[it->second] : nullptr;
+}
+
+void EventColumns::appendSeverity(const Event::Severity severity) {
+    const bool valid = severity != Event::Severity::Unknown;
+    appendBit(severity_validity_, severities_.size(), valid);
+    severities_.push_back(static_cast<int8_t>(severity));
+    severity_null_count_ += !valid;
+}
+
+namespace {
+
+// Exported arrays share ownership of the moved columns; each schema node owns its
+// strings. Children and dictionaries are released by their parent unless the consumer
+// moved them out, which leaves their release callback null.
+
+struct ArrayData {
+    std::shared_ptr<const EventColumns> owner;
+    std::vector<const void*> buffers;
+    std::vector<ArrowArray*> children;
+    ArrowArray* dictionary = nullptr;
+};
+
+struct SchemaData {
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema*> children;
+    ArrowSchema* dictionary = nullptr;
+};
+
+void releaseArray(ArrowArray* array) {
+    auto* data = static_cast<ArrayData*>(array->private_data);
+    for (ArrowArray* child : data->children) {
+        if (child->release != nullptr) {
+            child->release(child);
+        }
+        delete child;
+    }
+    if (data->dictionary != nullptr) {
+        if (data->dictionary->release != nullptr) {
+            data->dictionary->release(data->dictionary);
+        }
+        delete data->dictionary;
+    }
+    delete data;
+    array->release = nullptr;
+}
+
+void releaseSchema(ArrowSchema* schema) {
+    auto* data = static_cast<SchemaData*>(schema->private_data);
+    for (ArrowSchema* child : data->children) {
+        if (child->release != nullptr) {
+            child->release(child);
+        }
+        delete child;
+    }
+    if (data->dictionary != nullptr) {
+        if (data->dictionary->release != nullptr) {
+            data->dictionary->release(data->dictionary);
+        }
+        delete data->dictionary;
+    }
+    delete data;
+    schema->release = nullptr;
+}
+
+void fillArray(ArrowArray* out,
+               std::shared_ptr<const EventColumns> owner,
+               const size_t length,
+               const size_t null_count,
+               std::vector<const void*> buffers,
+               std::vector<ArrowArray*> children = {},
+               ArrowArray* dictionary = nullptr) {
+    auto* data = new ArrayData{std::move(owner), std::move(buffers), std::move(children),
+                               dictionary};
+    *out = ArrowArray{
+        .length = static_cast<int64_t>(length),
+        .null_count = static_cast<int64_t>(null_count),
+        .offset = 0,
+        .n_buffers = static_cast<int64_t>(data->buffers.size()),
+        .n_children = static_cast<int64_t>(data->children.size()),
+        .buffers = data->buffers.data(),
+        .children = data->children.data(),
+        .dictionary = data->dictionary,
+        .release = releaseArray,
+        .private_data = data,
+    };
+}
+
+void fillSchema(ArrowSchema* out,
+                std::string format,
+                std::string name,
+                const int64_t flags,
+                std::vector<ArrowSchema*> children = {},
+                ArrowSchema* dictionary = nullptr) {
+    auto* data = new SchemaData{std::move(format), std::move(name), std::move(children),
+                                dictionary};
+    *out = ArrowSchema{
+        .format = data->format.c_str(),
+        .name = data->name.c_str(),
+        .metadata = nullptr,
+        .flags = flags,
+        .n_children = static_cast<int64_t>(data->children.size()),
+        .children = data->children.data(),
+        .dictionary = data->dictionary,
+        .release = releaseSchema,
+        .private_data = data,
+    };
+}
+
+// Buffers of a utf8 array: validity (omitted without nulls), offsets and data
+std::vector<const void*> stringBuffers(const StringColumn& column) {
+    return {column.getNullCount() > 0 ? column.getValidity().data() : nullptr,
+            column.getOffsets().data(), column.getData().data()};
+}
+
+} // namespace
+
+void EventColumns::exportToArrow(ArrowSchema* schema, ArrowArray* array) {
+    static constexpr std::array<const char*, 5> header_names = {
+        "device_vendor", "device_product", "device_version", "device_event_class_id",
+        "name"};
+
+    const auto owner = std::make_shared<const EventColumns>(std::move(*this));
+    *this = EventColumns(owner->extension_keys_);
+
+    std::vector<ArrowSchema*> child_schemas;
+    std::vector<ArrowArray*> child_arrays;
+    const auto addChild = [&] {
+        child_schemas.push_back(new ArrowSchema());
+        child_arrays.push_back(new ArrowArray());
+    };
+    const size_t length = owner->size();
+
+    addChild();
+    fillSchema(child_schemas.back(), "i", "version", 0);
+    fillArray(child_arrays.back(), owner, length, 0, {nullptr, owner->versions_.data()});
+
+    for (size_t i = 0; i < owner->header_.size(); ++i) {
+        const DictionaryColumn& column = owner->header_[i];
+        addChild();
+
+        auto* dictionary_schema = new ArrowSchema();
+        fillSchema(dictionary_schema, "u", "", 0);
+        fillSchema(child_schemas.back(), "i", header_names[i], 0, {}, dictionary_schema);
+
+        auto* dictionary_array = new ArrowArray();
+        fillArray(dictionary_array, owner, column.getDictionary().size(), 0,
+                  stringBuffers(column.getDictionary()));
+        fillArray(child_arrays.back(), owner, length, 0,
+                  {nullptr, column.getIndices().data()}, {}, dictionary_array);
+    }
+
+    addChild();
+    fillSchema(child_schemas.back(), "c", "severity", ARROW_FLAG_NULLABLE);
+    const size_t severity_nulls = owner->severity_null_count_;
+    fillArray(child_arrays.back(), owner, length, severity_nulls,
+              {severity_nulls > 0 ? owner->severity_validity_.data() : nullptr,
+               owner->severities_.data()});
+
+    for (size_t i = 0; i < owner->extensions_.size(); ++i) {
+        const StringColumn& column = owner->extensions_[i];
+        addChild();
+        fillSchema(child_schemas.back(), "u", owner->extension_keys_[i],
+                   ARROW_FLAG_NULLABLE);
+        fillArray(child_arrays.back(), owner, length, column.getNullCount(),
+                  stringBuffers(column));
+    }
+
+    fillSchema(schema, "+s", "", 0, std::move(child_schemas));
+    fillArray(array, owner, length, 0, {nullptr}, std::move(child_arrays));
+}
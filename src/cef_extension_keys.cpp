@@ -0,0 +1,124 @@
+#include "cef_extension_keys.hpp"
+
+#include <arpa/inet.h>
+#include <charconv>
+
+using namespace cef_cpp;
+
+std::optional<IpAddress> IpAddress::parse(const std::string_view str) {
+    // inet_pton needs a terminated string; the longest IPv6 notation has 45 characters
+    char buffer[INET6_ADDRSTRLEN];
+    if (str.empty() || str.size() >= sizeof(buffer)) {
+        return std::nullopt;
+    }
+    str.copy(buffer, str.size());
+    buffer[str.size()] = '\0';
+
+    IpAddress address;
+    if (inet_pton(AF_INET, buffer, address.bytes.data()) == 1) {
+        address.family = Family::V4;
+        return address;
+    }
+    if (inet_pton(AF_INET6, buffer, address.bytes.data()) == 1) {
+        address.family = Family::V6;
+        return address;
+    }
+    return std::nullopt;
+}
+
+std::string IpAddress::toString() const {
+    char buffer[INET6_ADDRSTRLEN];
+    const int af = family == Family::V4 ? AF_INET : AF_INET6;
+    if (inet_ntop(af, bytes.data(), buffer, sizeof(buffer)) == nullptr) {
+        return {};
+    }
+    return buffer;
+}
+
+namespace {
+
+// Parse exactly @p digits decimal digits (or 1 to @p digits if @p exact is false)
+bool parseNumber(std::string_view& str, const size_t digits, const bool exact, int& value) {
+    size_t count = 0;
+    value = 0;
+    while (count < digits && count < str.size() && str[count] >= '0' && str[count] <= '9') {
+        value = value * 10 + (str[count] - '0');
+        ++count;
+    }
+    if (count == 0 || (exact && count != digits)) {
+        return false;
+    }
+    str.remove_prefix(count);
+    return true;
+}
+
+bool consume(std::string_view& str, const char c) {
+    if (str.empty() || str.front() != c) {
+        return false;
+    }
+    str.remove_prefix(1);
+    return true;
+}
+
+} // namespace
+
+std::optional<Timestamp> cef_cpp::parseTimestamp(std::string_view str) {
+    using namespace std::chrono;
+
+    // Milliseconds since the epoch
+    int64_t millis = 0;
+    if (const auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), millis);
+        ec == std::errc() && end == str.data() + str.size()) {
+        return Timestamp(milliseconds(millis));
+    }
+
+    // MMM dd yyyy HH:mm:ss[.SSS]
+    static constexpr std::string_view kMonths[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    unsigned month = 0;
+    while (month < 12 && !str.starts_with(kMonths[month])) {
+        ++month;
+    }
+    if (month == 12) {
+        return std::nullopt;
+    }
+    str.remove_prefix(3);
+
+    int day = 0;
+    int year_value = 0;
+    int hours = 0;
+    int minutes = 0;
+    int seconds = 0;
+    if (!consume(str, ' ') || !parseNumber(str, 2, false, day) || !consume(str, ' ') ||
+        !parseNumber(str, 4, true, year_value) || !consume(str, ' ') ||
+        !parseNumber(str, 2, true, hours) || !consume(str, ':') ||
+        !parseNumber(str, 2, true, minutes) || !consume(str, ':') ||
+        !parseNumber(str, 2, true, seconds)) {
+        return std::nullopt;
+    }
+
+    int fraction = 0;
+    if (consume(str, '.')) {
+        const size_t length = str.size();
+        if (!parseNumber(str, 3, false, fraction)) {
+            return std::nullopt;
+        }
+        for (size_t digits = length - str.size(); digits < 3; ++digits) {
+            fraction *= 10;
+        }
+    }
+
+    if (!str.empty() && str != " UTC" && str != " GMT" && str != " Z") {
+        return std::nullopt;
+    }
+
+    const year_month_day date{year(year_value), std::chrono::month(month + 1),
+                              std::chrono::day(static_cast<unsigned>(day))};
+    if (!date.ok() || hours > 23 || minutes > 59 || seconds > 60) {
+        return std::nullopt;
+    }
+
+    return Timestamp(sys_days(date)) + std::chrono::hours(hours) +
+           std::chrono::minutes(minutes) + std::chrono::seconds(seconds) +
+           milliseconds(fraction);
+}
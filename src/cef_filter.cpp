@@ -0,0 +1,587 @@
+#include "cef_filter.hpp"
+#include "cef_event.hpp"
+#include "cef_scanner.hpp"
+
+#include <boost/container/small_vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <optional>
+#include <span>
+
+using namespace cef_cpp;
+
+namespace {
+
+enum class Field : uint8_t {
+    Version,
+    DeviceVendor,
+    DeviceProduct,
+    DeviceVersion,
+    DeviceEventClassId,
+    Name,
+    Severity,
+    Extension
+};
+
+constexpr std::array<std::string_view, 7> header_field_names = {
+    "version", "deviceVendor", "deviceProduct", "deviceVersion", "deviceEventClassId",
+    "name",    "severity"};
+
+enum class Op : uint8_t {
+    And,
+    Or,
+    Not,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    In,
+    StartsWith,
+    Exists
+};
+
+struct Network {
+    IpAddress address;
+    unsigned prefix_length = 0;
+
+    bool contains(const IpAddress& other) const {
+        if (other.family != address.family) {
+            return false;
+        }
+        const unsigned full_bytes = prefix_length / 8;
+        if (!std::equal(address.bytes.begin(), address.bytes.begin() + full_bytes,
+                        other.bytes.begin())) {
+            return false;
+        }
+        const unsigned rest = prefix_length % 8;
+        if (rest == 0) {
+            return true;
+        }
+        const auto mask = static_cast<uint8_t>(0xff << (8 - rest));
+        return (address.bytes[full_bytes] & mask) == (other.bytes[full_bytes] & mask);
+    }
+};
+
+std::optional<double> toNumber(const std::string_view str) {
+    double value = 0;
+    const auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (str.empty() || ec != std::errc() || end != str.data() + str.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<Network> toNetwork(const std::string_view str) {
+    const size_t slash = str.find('/');
+    if (slash == std::string_view::npos) {
+        return std::nullopt;
+    }
+    const auto address = IpAddress::parse(str.substr(0, slash));
+    const std::string_view length = str.substr(slash + 1);
+    unsigned prefix_length = 0;
+    const auto [end, ec] =
+        std::from_chars(length.data(), length.data() + length.size(), prefix_length);
+    if (!address || length.empty() || ec != std::errc() ||
+        end != length.data() + length.size() ||
+        prefix_length > (address->family == IpAddress::Family::V4 ? 32u : 128u)) {
+        return std::nullopt;
+    }
+    return Network{*address, prefix_length};
+}
+
+bool equalsIgnoreCase(const std::string_view lhs, const std::string_view rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                      [](const char a, const char b) {
+                          return (a | 0x20) == (b | 0x20);
+                      });
+}
+
+} // namespace
+
+struct Filter::Node {
+    Op op;
+    Field field = Field::Version;
+    // Index into extension_keys_ for Field::Extension
+    uint32_t slot = 0;
+    // Operands of And, Or and Not
+    uint32_t lhs = 0;
+    uint32_t rhs = 0;
+
+    std::string literal{};
+    std::optional<double> number{};
+    // Members of an In set, sorted
+    std::vector<std::string> values{};
+    std::vector<Network> networks{};
+};
+
+/**
+ * @brief Field values an expression is evaluated against
+ */
+struct Filter::Input {
+    // Indexed by Field; std::nullopt for an unknown severity
+    std::array<std::optional<std::string_view>, 7> header;
+    // Indexed by extension slot
+    std::span<const std::optional<std::string_view>> extensions;
+    // Values are raw CEF and may still contain escape sequences
+    bool escaped = false;
+    bool extensions_known = true;
+};
+
+/**
+ * @brief Recursive-descent compiler from an expression to nodes
+ */
+class Filter::Compiler {
+public:
+    Compiler(Filter& filter, const std::string_view expression)
+        : filter_(filter), expression_(expression) {
+        tokenize();
+    }
+
+    uint32_t compile() {
+        const uint32_t root = parseOr();
+        if (peek().kind != Token::End) {
+            fail("unexpected '" + peek().text + "'");
+        }
+        return root;
+    }
+
+private:
+    struct Token {
+        enum Kind {
+            Word,
+            String,
+            Compare,
+            LeftParen,
+            RightParen,
+            Comma,
+            Not,
+            And,
+            Or,
+            End
+        };
+
+        Kind kind;
+        std::string text;
+        size_t offset;
+    };
+
+    Filter& filter_;
+    std::string_view expression_;
+    std::vector<Token> tokens_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw FilterException(message, tokens_.empty() ? 0 : peek().offset);
+    }
+
+    void tokenize() {
+        size_t i = 0;
+        // The text defaults to the consumed characters; '==' is stored as '='
+        const auto add = [&](const Token::Kind kind, const size_t length,
+                             const std::string_view text = {}) {
+            tokens_.push_back(
+                {kind, std::string(text.empty() ? expression_.substr(i, length) : text), i});
+            i += length;
+        };
+        const auto next = [&](const size_t offset) {
+            return i + offset < expression_.size() ? expression_[i + offset] : '\0';
+        };
+
+        while (i < expression_.size()) {
+            const char c = expression_[i];
+            if (detail::isSpaceChar(c)) {
+                ++i;
+            } else if (c == '(') {
+                add(Token::LeftParen, 1);
+            } else if (c == ')') {
+                add(Token::RightParen, 1);
+            } else if (c == ',') {
+                add(Token::Comma, 1);
+            } else if (c == '=') {
+                add(Token::Compare, next(1) == '=' ? 2 : 1, "=");
+            } else if (c == '!') {
+                add(next(1) == '=' ? Token::Compare : Token::Not, next(1) == '=' ? 2 : 1);
+            } else if (c == '<' || c == '>') {
+                add(Token::Compare, next(1) == '=' ? 2 : 1);
+            } else if ((c == '&' || c == '|') && next(1) == c) {
+                add(c == '&' ? Token::And : Token::Or, 2);
+            } else if (c == '&' || c == '|') {
+                throw FilterException(std::string("expected '") + c + c + "'", i);
+            } else if (c == '"') {
+                tokenizeString(i);
+            } else {
+                constexpr std::string_view delimiters = "()!=<>,\"&|";
+                size_t end = i;
+                while (end < expression_.size() && !detail::isSpaceChar(expression_[end]) &&
+                       delimiters.find(expression_[end]) == std::string_view::npos) {
+                    ++end;
+                }
+                add(Token::Word, end - i);
+            }
+        }
+        tokens_.push_back({Token::End, "end of expression", expression_.size()});
+    }
+
+    void tokenizeString(size_t& i) {
+        const size_t begin = i++;
+        std::string text;
+        while (i < expression_.size() && expression_[i] != '"') {
+            if (expression_[i] == '\\' && i + 1 < expression_.size()) {
+                ++i;
+            }
+            text += expression_[i++];
+        }
+        if (i == expression_.size()) {
+            throw FilterException("unterminated string", begin);
+        }
+        ++i;
+        tokens_.push_back({Token::String, std::move(text), begin});
+    }
+
+    const Token& peek(const size_t ahead = 0) const {
+        return tokens_[std::min(pos_ + ahead, tokens_.size() - 1)];
+    }
+
+    bool isKeyword(const Token& token, const std::string_view keyword) const {
+        return token.kind == Token::Word && equalsIgnoreCase(token.text, keyword);
+    }
+
+    bool accept(const Token::Kind kind) {
+        if (peek().kind == kind) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool acceptKeyword(const std::string_view keyword) {
+        if (isKeyword(peek(), keyword)) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const Token::Kind kind, const char* description) {
+        if (!accept(kind)) {
+            fail(std::string("expected ") + description);
+        }
+    }
+
+    uint32_t add(Node node) {
+        filter_.nodes_.push_back(std::move(node));
+        return static_cast<uint32_t>(filter_.nodes_.size() - 1);
+    }
+
+    uint32_t parseOr() {
+        uint32_t node = parseAnd();
+        while (acceptKeyword("or") || accept(Token::Or)) {
+            node = add({.op = Op::Or, .lhs = node, .rhs = parseAnd()});
+        }
+        return node;
+    }
+
+    uint32_t parseAnd() {
+        uint32_t node = parseUnary();
+        while (acceptKeyword("and") || accept(Token::And)) {
+            node = add({.op = Op::And, .lhs = node, .rhs = parseUnary()});
+        }
+        return node;
+    }
+
+    uint32_t parseUnary() {
+        if (acceptKeyword("not") || accept(Token::Not)) {
+            return add({.op = Op::Not, .lhs = parseUnary()});
+        }
+        if (accept(Token::LeftParen)) {
+            const uint32_t node = parseOr();
+            expect(Token::RightParen, "')'");
+            return node;
+        }
+        if (isKeyword(peek(), "exists") && peek(1).kind == Token::LeftParen) {
+            pos_ += 2;
+            Node node{.op = Op::Exists};
+            parseField(node);
+            expect(Token::RightParen, "')'");
+            return add(std::move(node));
+        }
+        return parsePredicate();
+    }
+
+    uint32_t parsePredicate() {
+        Node node{.op = Op::Equal};
+        parseField(node);
+
+        if (peek().kind == Token::Compare) {
+            const std::string& op = tokens_[pos_++].text;
+            node.op = op == "=" ? Op::Equal
+                      : op == "!=" ? Op::NotEqual
+                      : op == "<"  ? Op::Less
+                      : op == "<=" ? Op::LessEqual
+                      : op == ">"  ? Op::Greater
+                                   : Op::GreaterEqual;
+            node.literal = parseValue();
+            node.number = toNumber(node.literal);
+            return add(std::move(node));
+        }
+        if (acceptKeyword("in")) {
+            return parseSet(std::move(node));
+        }
+        if (isKeyword(peek(), "not") && isKeyword(peek(1), "in")) {
+            pos_ += 2;
+            const uint32_t set = parseSet(std::move(node));
+            return add({.op = Op::Not, .lhs = set});
+        }
+        if (acceptKeyword("startswith")) {
+            node.op = Op::StartsWith;
+            node.literal = parseValue();
+            return add(std::move(node));
+        }
+        fail("expected an operator");
+    }
+
+    uint32_t parseSet(Node node) {
+        node.op = Op::In;
+        const auto add_member = [&] {
+            std::string value = parseValue();
+            if (const auto network = toNetwork(value)) {
+                node.networks.push_back(*network);
+            } else {
+                node.values.push_back(std::move(value));
+            }
+        };
+
+        if (accept(Token::LeftParen)) {
+            do {
+                add_member();
+            } while (accept(Token::Comma));
+            expect(Token::RightParen, "')' or ','");
+        } else {
+            add_member();
+        }
+        std::sort(node.values.begin(), node.values.end());
+        return add(std::move(node));
+    }
+
+    void parseField(Node& node) {
+        if (peek().kind != Token::Word) {
+            fail("expected a field name");
+        }
+        const std::string& name = tokens_[pos_++].text;
+
+        const auto& headers = header_field_names;
+        const auto header = std::find(headers.begin(), headers.end(), name);
+        if (header != headers.end()) {
+            node.field = static_cast<Field>(header - headers.begin());
+            return;
+        }
+
+        // Extensions are matched by short key; full names are translated
+        const std::string_view key = toExtensionKeyName(name);
+        auto& keys = filter_.extension_keys_;
+        const auto it = std::find(keys.begin(), keys.end(), key);
+        node.field = Field::Extension;
+        node.slot = static_cast<uint32_t>(it - keys.begin());
+        if (it == keys.end()) {
+            keys.emplace_back(key);
+        }
+    }
+
+    std::string parseValue() {
+        if (peek().kind != Token::Word && peek().kind != Token::String) {
+            fail("expected a value");
+        }
+        return tokens_[pos_++].text;
+    }
+};
+
+Filter::Filter(const std::string_view expression) : expression_(expression) {
+    root_ = Compiler(*this, expression_).compile();
+}
+
+Filter::Filter(const Filter&) = default;
+Filter::Filter(Filter&&) noexcept = default;
+Filter& Filter::operator=(const Filter&) = default;
+Filter& Filter::operator=(Filter&&) noexcept = default;
+Filter::~Filter() = default;
+
+namespace {
+
+using ExtensionValues =
+    boost::container::small_vector<std::optional<std::string_view>, 8>;
+
+// Formats a header integer into @p buffer
+std::string_view formatInt(const int value, std::array<char, 16>& buffer) {
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    return std::string_view(buffer.data(), result.ptr - buffer.data());
+}
+
+} // namespace
+
+bool Filter::matches(const Event& event) const {
+    std::array<char, 16> version;
+    std::array<char, 16> severity;
+
+    Input input;
+    input.header = {formatInt(event.getVersion(), version), event.getDeviceVendor(),
+                    event.getDeviceProduct(), event.getDeviceVersion(),
+                    event.getDeviceEventClassId(), event.getName(), std::nullopt};
+    if (event.getSeverity() != Event::Severity::Unknown) {
+        input.header[6] = formatInt(static_cast<int>(event.getSeverity()), severity);
+    }
+
+    ExtensionValues extensions(extension_keys_.size());
+    if (!extension_keys_.empty()) {
+        const ExtensionMap& map = event.getExtensions();
+        for (size_t i = 0; i < extension_keys_.size(); ++i) {
+            if (const auto it = map.find(extension_keys_[i]); it != map.end()) {
+                extensions[i] = it->second;
+            }
+        }
+    }
+    input.extensions = {extensions.data(), extensions.size()};
+    return evaluate(root_, input) == Match::True;
+}
+
+bool Filter::matches(const EventView& view) const {
+    return evaluate(view, true) == Match::True;
+}
+
+Filter::Match Filter::evaluate(const EventView& view, const bool extensions_known) const {
+    std::array<char, 16> version;
+    std::array<char, 16> severity;
+
+    Input input;
+    input.escaped = true;
+    input.extensions_known = extensions_known;
+    input.header = {formatInt(view.getVersion(), version), view.getRawDeviceVendor(),
+                    view.getRawDeviceProduct(), view.getRawDeviceVersion(),
+                    view.getRawDeviceEventClassId(), view.getRawName(), std::nullopt};
+    if (view.getSeverity() != Event::Severity::Unknown) {
+        input.header[6] = formatInt(static_cast<int>(view.getSeverity()), severity);
+    }
+
+    ExtensionValues extensions(extension_keys_.size());
+    if (extensions_known && !extension_keys_.empty()) {
+        // Later duplicates overwrite earlier ones, as in Event
+        for (const auto& [key, value] : view.getRawExtensions()) {
+            const auto& keys = extension_keys_;
+            const auto it = std::find(keys.begin(), keys.end(), key);
+            if (it != keys.end()) {
+                extensions[it - keys.begin()] = value;
+            }
+        }
+    }
+    input.extensions = {extensions.data(), extensions.size()};
+    return evaluate(root_, input);
+}
+
+Filter::Match Filter::evaluate(const uint32_t index, const Input& input) const {
+    const Node& node = nodes_[index];
+
+    switch (node.op) {
+    case Op::And: {
+        const Match lhs = evaluate(node.lhs, input);
+        if (lhs == Match::False) {
+            return Match::False;
+        }
+        const Match rhs = evaluate(node.rhs, input);
+        if (rhs == Match::False) {
+            return Match::False;
+        }
+        return lhs == Match::True ? rhs : Match::Unknown;
+    }
+    case Op::Or: {
+        const Match lhs = evaluate(node.lhs, input);
+        if (lhs == Match::True) {
+            return Match::True;
+        }
+        const Match rhs = evaluate(node.rhs, input);
+        if (rhs == Match::True) {
+            return Match::True;
+        }
+        return lhs == Match::False ? rhs : Match::Unknown;
+    }
+    case Op::Not: {
+        const Match operand = evaluate(node.lhs, input);
+        return operand == Match::Unknown ? Match::Unknown
+               : operand == Match::True  ? Match::False
+                                         : Match::True;
+    }
+    default:
+        break;
+    }
+
+    if (node.field == Field::Extension && !input.extensions_known) {
+        return Match::Unknown;
+    }
+    const std::optional<std::string_view> field =
+        node.field == Field::Extension ? input.extensions[node.slot]
+                                       : input.header[static_cast<size_t>(node.field)];
+    if (node.op == Op::Exists) {
+        return field ? Match::True : Match::False;
+    }
+    if (!field) {
+        return node.op == Op::NotEqual ? Match::True : Match::False;
+    }
+
+    std::string unescaped;
+    std::string_view value = *field;
+    if (input.escaped && value.find('\\') != std::string_view::npos) {
+        unescaped = detail::unescape(value);
+        value = unescaped;
+    }
+
+    const auto compare = [&] {
+        const auto number = node.number ? toNumber(value) : std::nullopt;
+        if (number) {
+            return *number < *node.number ? -1 : *number > *node.number ? 1 : 0;
+        }
+        const int result = value.compare(node.literal);
+        return result < 0 ? -1 : result > 0 ? 1 : 0;
+    };
+
+    bool result = false;
+    switch (node.op) {
+    case Op::Equal:
+        result = compare() == 0;
+        break;
+    case Op::NotEqual:
+        result = compare() != 0;
+        break;
+    case Op::Less:
+        result = compare() < 0;
+        break;
+    case Op::LessEqual:
+        result = compare() <= 0;
+        break;
+    case Op::Greater:
+        result = compare() > 0;
+        break;
+    case Op::GreaterEqual:
+        result = compare() >= 0;
+        break;
+    case Op::In:
+        result = std::binary_search(node.values.begin(), node.values.end(), value,
+                                    std::less<>());
+        if (!result && !node.networks.empty()) {
+            if (const auto address = IpAddress::parse(value)) {
+                result = std::any_of(node.networks.begin(), node.networks.end(),
+                                     [&](const Network& network) {
+                                         return network.contains(*address);
+                                     });
+            }
+        }
+        break;
+    case Op::StartsWith:
+        result = value.starts_with(node.literal);
+        break;
+    default:
+        break;
+    }
+    return result ? Match::True : Match::False;
+}
@@ -0,0 +1,472 @@
+#include "cef_ingest_server.hpp"
+#include "cef_ring_buffer.hpp"
+#include "cef_scanner.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+using namespace cef_cpp;
+
+namespace {
+
+constexpr size_t kReadSize = 64 * 1024;
+constexpr int kMaxEpollEvents = 64;
+
+[[noreturn]] void throwSystemError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+struct IngestServer::Connection {
+    int fd = -1;
+    // Received bytes [0, end) not yet consumed as frames
+    std::string buffer;
+    size_t end = 0;
+};
+
+struct IngestServer::DatagramBuffers {
+    std::vector<char> data;
+    std::vector<iovec> iovecs;
+    std::vector<mmsghdr> headers;
+};
+
+struct IngestServer::Counters {
+    // Written by the network thread
+    alignas(64) std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> bytes_received{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> truncated{0};
+    std::atomic<uint64_t> backpressure_waits{0};
+    std::atomic<uint64_t> connections_accepted{0};
+    std::atomic<uint64_t> connections_rejected{0};
+
+    // Written by the workers
+    alignas(64) std::atomic<uint64_t> parsed{0};
+    alignas(64) std::atomic<uint64_t> parse_errors{0};
+    std::atomic<uint64_t> filtered{0};
+};
+
+IngestServer::IngestServer(const IngestOptions& options,
+                           EventCallback on_event,
+                           ErrorCallback on_error)
+    : options_(options),
+      on_event_(std::move(on_event)),
+      on_error_(std::move(on_error)),
+      queue_(std::make_unique<detail::MpmcRingBuffer<std::string>>(options.queue_capacity)),
+      counters_(std::make_unique<Counters>()) {
+    if (!options_.udp_port && !options_.tcp_port) {
+        throw std::invalid_argument("IngestServer needs a UDP or a TCP port");
+    }
+
+    try {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) {
+            throwSystemError("epoll_create1");
+        }
+
+        stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = stop_fd_;
+        if (stop_fd_ < 0 || epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &event) != 0) {
+            throwSystemError("eventfd");
+        }
+
+        if (options_.udp_port) {
+            setupUdp();
+        }
+        if (options_.tcp_port) {
+            setupTcp();
+        }
+    } catch (...) {
+        closeSockets();
+        throw;
+    }
+
+    size_t worker_count = options_.worker_count;
+    if (worker_count == 0) {
+        worker_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    try {
+        workers_.reserve(worker_count);
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers_.emplace_back(&IngestServer::workerLoop, this);
+        }
+        network_thread_ = std::thread(&IngestServer::networkLoop, this);
+    } catch (...) {
+        // Threads that did start must be joined before they are destroyed
+        receiving_ = false;
+        stopWorkers();
+        closeSockets();
+        throw;
+    }
+}
+
+IngestServer::~IngestServer() {
+    try {
+        stop();
+    } catch (...) {
+        // A failure of the network thread is only reported by an explicit stop()
+    }
+}
+
+void IngestServer::stop() {
+    if (!receiving_.exchange(false)) {
+        return;
+    }
+
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = ::write(stop_fd_, &one, sizeof(one));
+    network_thread_.join();
+
+    stopWorkers();
+    closeSockets();
+
+    if (network_error_) {
+        std::rethrow_exception(std::exchange(network_error_, nullptr));
+    }
+}
+
+void IngestServer::stopWorkers() {
+    // No more pushes: let the workers drain the queue and exit
+    stopped_.store(true, std::memory_order_release);
+    pushed_.fetch_add(1, std::memory_order_release);
+    pushed_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+IngestStats IngestServer::getStats() const {
+    IngestStats stats;
+    stats.received = counters_->received.load(std::memory_order_relaxed);
+    stats.bytes_received = counters_->bytes_received.load(std::memory_order_relaxed);
+    stats.parsed = counters_->parsed.load(std::memory_order_relaxed);
+    stats.parse_errors = counters_->parse_errors.load(std::memory_order_relaxed);
+    stats.filtered = counters_->filtered.load(std::memory_order_relaxed);
+    stats.dropped = counters_->dropped.load(std::memory_order_relaxed);
+    stats.truncated = counters_->truncated.load(std::memory_order_relaxed);
+    stats.backpressure_waits = counters_->backpressure_waits.load(std::memory_order_relaxed);
+    stats.connections_accepted =
+        counters_->connections_accepted.load(std::memory_order_relaxed);
+    stats.connections_rejected =
+        counters_->connections_rejected.load(std::memory_order_relaxed);
+    return stats;
+}
+
+namespace {
+
+int bindSocket(const int type, const std::string& address, const uint16_t port,
+               uint16_t& bound_port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        throw std::invalid_argument("Invalid IPv4 bind address: " + address);
+    }
+
+    const int fd = socket(AF_INET, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throwSystemError("socket");
+    }
+
+    const int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        const int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "bind");
+    }
+
+    socklen_t length = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    bound_port = ntohs(addr.sin_port);
+    return fd;
+}
+
+void addToEpoll(const int epoll_fd, const int fd) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        throwSystemError("epoll_ctl");
+    }
+}
+
+} // namespace
+
+void IngestServer::setupUdp() {
+    udp_fd_ = bindSocket(SOCK_DGRAM, options_.bind_address, *options_.udp_port, udp_port_);
+
+    // A large receive buffer absorbs bursts; the kernel may cap it
+    const int buffer_size = 8 * 1024 * 1024;
+    setsockopt(udp_fd_, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+    addToEpoll(epoll_fd_, udp_fd_);
+
+    const size_t batch_size = std::max<size_t>(options_.udp_batch_size, 1);
+    const size_t datagram_size = std::max<size_t>(options_.max_message_size, 1);
+    datagram_buffers_ = std::make_unique<DatagramBuffers>();
+    datagram_buffers_->data.resize(batch_size * datagram_size);
+    datagram_buffers_->iovecs.resize(batch_size);
+    datagram_buffers_->headers.resize(batch_size);
+}
+
+void IngestServer::setupTcp() {
+    tcp_fd_ = bindSocket(SOCK_STREAM, options_.bind_address, *options_.tcp_port, tcp_port_);
+    if (listen(tcp_fd_, SOMAXCONN) != 0) {
+        throwSystemError("listen");
+    }
+    addToEpoll(epoll_fd_, tcp_fd_);
+}
+
+void IngestServer::closeSockets() {
+    for (const auto& [fd, connection] : connections_) {
+        close(fd);
+    }
+    connections_.clear();
+
+    for (int* fd : {&udp_fd_, &tcp_fd_, &stop_fd_, &epoll_fd_}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void IngestServer::networkLoop() {
+    try {
+        epoll_event events[kMaxEpollEvents];
+        while (receiving_.load(std::memory_order_acquire)) {
+            const int count = epoll_wait(epoll_fd_, events, kMaxEpollEvents, -1);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throwSystemError("epoll_wait");
+            }
+
+            for (int i = 0; i < count; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == stop_fd_) {
+                    return;
+                }
+                if (fd == udp_fd_) {
+                    receiveDatagrams();
+                } else if (fd == tcp_fd_) {
+                    acceptConnections();
+                } else if (const auto it = connections_.find(fd); it != connections_.end()) {
+                    if (!readConnection(*it->second)) {
+                        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+                        close(fd);
+                        connections_.erase(it);
+                    }
+                }
+            }
+        }
+    } catch (...) {
+        // Kept for stop() to rethrow; the workers still drain what was queued
+        network_error_ = std::current_exception();
+        network_failed_.store(true, std::memory_order_release);
+    }
+}
+
+void IngestServer::receiveDatagrams() {
+    const size_t batch_size = std::max<size_t>(options_.udp_batch_size, 1);
+    const size_t datagram_size = std::max<size_t>(options_.max_message_size, 1);
+
+    std::vector<char>& buffer = datagram_buffers_->data;
+    std::vector<iovec>& iovecs = datagram_buffers_->iovecs;
+    std::vector<mmsghdr>& headers = datagram_buffers_->headers;
+
+    while (true) {
+        for (size_t i = 0; i < batch_size; ++i) {
+            iovecs[i] = {buffer.data() + i * datagram_size, datagram_size};
+            headers[i] = {};
+            headers[i].msg_hdr.msg_iov = &iovecs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int count = recvmmsg(udp_fd_, headers.data(), static_cast<unsigned>(batch_size),
+                                   MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            // recvmmsg cuts longer datagrams silently; parsing a prefix would be wrong
+            if (headers[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                counters_->truncated.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            const std::string_view datagram(buffer.data() + i * datagram_size,
+                                            headers[i].msg_len);
+            // Some senders pack several newline-separated messages into one datagram
+            detail::forEachLine(datagram, [&](const std::string_view line) {
+                enqueue(line);
+                return true;
+            });
+        }
+
+        if (static_cast<size_t>(count) < batch_size) {
+            return;
+        }
+    }
+}
+
+void IngestServer::acceptConnections() {
+    while (true) {
+        const int fd = accept4(tcp_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connections_.emplace(fd, std::move(connection));
+        counters_->connections_accepted.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool IngestServer::readConnection(Connection& connection) {
+    while (true) {
+        if (connection.buffer.size() - connection.end < kReadSize) {
+            connection.buffer.resize(connection.end + kReadSize);
+        }
+
+        const ssize_t count = ::read(connection.fd, connection.buffer.data() + connection.end,
+                                     connection.buffer.size() - connection.end);
+        if (count > 0) {
+            connection.end += static_cast<size_t>(count);
+            if (!processFrames(connection, false)) {
+                return false;
+            }
+            continue;
+        }
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+
+        // End of stream: an unterminated last line is still a message
+        if (count == 0) {
+            processFrames(connection, true);
+        }
+        return false;
+    }
+}
+
+bool IngestServer::processFrames(Connection& connection, const bool end_of_input) {
+    size_t pos = 0;
+    bool valid = true;
+    while (true) {
+        std::string_view frame;
+        size_t consumed = 0;
+        const auto status = extractSyslogFrame(
+            std::string_view(connection.buffer.data() + pos, connection.end - pos),
+            end_of_input, frame, consumed);
+        if (status == FrameStatus::Invalid || frame.size() > options_.max_message_size) {
+            valid = false;
+            break;
+        }
+
+        pos += consumed;
+        if (status == FrameStatus::Incomplete) {
+            break;
+        }
+        if (!detail::trim(frame).empty()) {
+            enqueue(frame);
+        }
+    }
+
+    // Keep the partial frame at the front of the buffer
+    std::memmove(connection.buffer.data(), connection.buffer.data() + pos,
+                 connection.end - pos);
+    connection.end -= pos;
+
+    // The length prefix or pending line of a frame that can never fit
+    if (valid && connection.end > options_.max_message_size + 16) {
+        valid = false;
+    }
+    if (!valid) {
+        counters_->connections_rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+    return valid;
+}
+
+void IngestServer::enqueue(const std::string_view message) {
+    counters_->received.fetch_add(1, std::memory_order_relaxed);
+    counters_->bytes_received.fetch_add(message.size(), std::memory_order_relaxed);
+
+    const auto fill = [&](std::string& slot) { slot.assign(message); };
+    while (!queue_->tryPush(fill)) {
+        if (options_.drop_when_full || !receiving_.load(std::memory_order_relaxed)) {
+            counters_->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Wait until a worker frees a slot
+        counters_->backpressure_waits.fetch_add(1, std::memory_order_relaxed);
+        const uint32_t seen = popped_.load(std::memory_order_acquire);
+        if (queue_->tryPush(fill)) {
+            break;
+        }
+        popped_.wait(seen, std::memory_order_acquire);
+    }
+
+    pushed_.fetch_add(1, std::memory_order_release);
+    pushed_.notify_one();
+}
+
+void IngestServer::workerLoop() {
+    std::string message;
+    while (true) {
+        const uint32_t seen = pushed_.load(std::memory_order_acquire);
+        if (queue_->tryPop([&](std::string& slot) { message.swap(slot); })) {
+            popped_.fetch_add(1, std::memory_order_release);
+            popped_.notify_one();
+
+            auto event = Parser::tryParse(message, options_.parse_options);
+            if (event) {
+                counters_->parsed.fetch_add(1, std::memory_order_relaxed);
+                if (on_event_) {
+                    on_event_(std::move(*event));
+                }
+            } else if (event.error().code == ParseErrorCode::Filtered) {
+                counters_->filtered.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                counters_->parse_errors.fetch_add(1, std::memory_order_relaxed);
+                if (on_error_) {
+                    on_error_(message, event.error());
+                }
+            }
+            continue;
+        }
+
+        if (stopped_.load(std::memory_order_acquire)) {
+            return;
+        }
+        pushed_.wait(seen, std::memory_order_acquire);
+    }
+}
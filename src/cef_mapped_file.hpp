@@ -0,0 +1,32 @@
+#ifndef CEF_CPP_CEF_MAPPED_FILE_H
+#define CEF_CPP_CEF_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace cef_cpp::detail {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * @throws std::system_error if the file cannot be opened or mapped
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view data() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace cef_cpp::detail
+
+#endif
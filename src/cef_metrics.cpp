@@ -0,0 +1,212 @@
+#include "cef_metrics.hpp"
+#include "cef_metrics_recorder.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <mutex>
+#include <vector>
+
+using namespace cef_cpp;
+
+namespace {
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<const detail::ThreadMetrics*> threads;
+    // Counts of threads that have exited
+    ParserMetrics retired;
+    // Counts at the last reset()
+    ParserMetrics baseline;
+};
+
+Registry& registry() {
+    // Leaked on purpose: threads may exit after static destruction has begun
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+uint64_t load(const std::atomic<uint64_t>& counter) {
+    return counter.load(std::memory_order_relaxed);
+}
+
+void add(Histogram& histogram, const detail::AtomicHistogram& counters) {
+    for (size_t i = 0; i < Histogram::kBuckets; ++i) {
+        histogram.buckets[i] += load(counters.buckets[i]);
+    }
+    histogram.count += load(counters.count);
+    histogram.sum += load(counters.sum);
+}
+
+void add(ParserMetrics& metrics, const detail::ThreadMetrics& counters) {
+    metrics.lines += load(counters.lines);
+    metrics.bytes += load(counters.bytes);
+    metrics.events += load(counters.events);
+    for (size_t i = 0; i < kParseErrorCodeCount; ++i) {
+        metrics.errors[i] += load(counters.errors[i]);
+    }
+    add(metrics.extensions, counters.extensions);
+    add(metrics.header_split, counters.stages[static_cast<size_t>(detail::Stage::HeaderSplit)]);
+    add(metrics.extension_tokenize,
+        counters.stages[static_cast<size_t>(detail::Stage::ExtensionTokenize)]);
+    add(metrics.unescape, counters.stages[static_cast<size_t>(detail::Stage::Unescape)]);
+}
+
+void subtract(Histogram& histogram, const Histogram& baseline) {
+    for (size_t i = 0; i < Histogram::kBuckets; ++i) {
+        histogram.buckets[i] -= baseline.buckets[i];
+    }
+    histogram.count -= baseline.count;
+    histogram.sum -= baseline.sum;
+}
+
+void subtract(ParserMetrics& metrics, const ParserMetrics& baseline) {
+    metrics.lines -= baseline.lines;
+    metrics.bytes -= baseline.bytes;
+    metrics.events -= baseline.events;
+    for (size_t i = 0; i < kParseErrorCodeCount; ++i) {
+        metrics.errors[i] -= baseline.errors[i];
+    }
+    subtract(metrics.extensions, baseline.extensions);
+    subtract(metrics.header_split, baseline.header_split);
+    subtract(metrics.extension_tokenize, baseline.extension_tokenize);
+    subtract(metrics.unescape, baseline.unescape);
+}
+
+// Sum of all threads since startup; the caller holds the registry lock
+ParserMetrics total(const Registry& registry) {
+    ParserMetrics metrics = registry.retired;
+    for (const detail::ThreadMetrics* counters : registry.threads) {
+        add(metrics, *counters);
+    }
+    return metrics;
+}
+
+const char* reasonLabel(const ParseErrorCode code) {
+    switch (code) {
+    case ParseErrorCode::EmptyLine:
+        return "empty_line";
+    case ParseErrorCode::MissingPrefix:
+        return "missing_prefix";
+    case ParseErrorCode::TooFewFields:
+        return "too_few_fields";
+    case ParseErrorCode::EmptyField:
+        return "empty_field";
+    case ParseErrorCode::InvalidVersion:
+        return "invalid_version";
+    case ParseErrorCode::InvalidSeverity:
+        return "invalid_severity";
+    case ParseErrorCode::InvalidSyslogHeader:
+        return "invalid_syslog_header";
+    case ParseErrorCode::Filtered:
+        return "filtered";
+    default:
+        return "unknown";
+    }
+}
+
+void appendNumber(std::string& out, const double value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void appendHeader(std::string& out, const std::string& name, const char* help,
+                  const char* type) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
+
+void appendCounter(std::string& out, const std::string& name, const char* help,
+                   const uint64_t value) {
+    appendHeader(out, name, help, "counter");
+    out += name + " " + std::to_string(value) + "\n";
+}
+
+// Samples of one histogram; labels are prepended to le and the bounds and the sum are
+// divided by unit to convert them to the exported unit
+void appendHistogram(std::string& out, const std::string& name, const std::string& labels,
+                     const Histogram& histogram, const double unit) {
+    const std::string separator = labels.empty() ? "" : ",";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < Histogram::kBuckets; ++i) {
+        cumulative += histogram.buckets[i];
+        out += name + "_bucket{" + labels + separator + "le=\"";
+        if (i + 1 < Histogram::kBuckets) {
+            appendNumber(out, static_cast<double>(histogram.getUpperBound(i)) / unit);
+        } else {
+            out += "+Inf";
+        }
+        out += "\"} " + std::to_string(cumulative) + "\n";
+    }
+
+    const std::string suffix = labels.empty() ? "" : "{" + labels + "}";
+    out += name + "_sum" + suffix + " ";
+    appendNumber(out, static_cast<double>(histogram.sum) / unit);
+    out += "\n" + name + "_count" + suffix + " " + std::to_string(histogram.count) + "\n";
+}
+
+} // namespace
+
+detail::ThreadMetrics::ThreadMetrics() {
+    Registry& registry = ::registry();
+    std::lock_guard lock(registry.mutex);
+    registry.threads.push_back(this);
+}
+
+detail::ThreadMetrics::~ThreadMetrics() {
+    Registry& registry = ::registry();
+    std::lock_guard lock(registry.mutex);
+    add(registry.retired, *this);
+    registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+}
+
+detail::ThreadMetrics& detail::threadMetrics() {
+    thread_local ThreadMetrics metrics;
+    return metrics;
+}
+
+ParserMetrics Metrics::snapshot() {
+    Registry& registry = ::registry();
+    std::lock_guard lock(registry.mutex);
+    ParserMetrics metrics = total(registry);
+    subtract(metrics, registry.baseline);
+    return metrics;
+}
+
+void Metrics::reset() {
+    // Owner threads write their counters without synchronization, so rather than
+    // clearing them, later snapshots subtract the counts as of now
+    Registry& registry = ::registry();
+    std::lock_guard lock(registry.mutex);
+    registry.baseline = total(registry);
+}
+
+std::string ParserMetrics::toPrometheus(const std::string_view prefix) const {
+    const std::string name(prefix);
+    std::string out;
+
+    appendCounter(out, name + "_lines_total", "Lines handed to the parser.", lines);
+    appendCounter(out, name + "_bytes_total", "CEF payload bytes handed to the parser.",
+                  bytes);
+    appendCounter(out, name + "_events_total", "Lines parsed into events.", events);
+
+    const std::string errors_name = name + "_errors_total";
+    appendHeader(out, errors_name, "Lines rejected by the parser, by reason.", "counter");
+    for (size_t i = 0; i < kParseErrorCodeCount; ++i) {
+        out += errors_name + "{reason=\"" + reasonLabel(static_cast<ParseErrorCode>(i)) +
+               "\"} " + std::to_string(errors[i]) + "\n";
+    }
+
+    const std::string extensions_name = name + "_extensions";
+    appendHeader(out, extensions_name, "Extensions per parsed event.", "histogram");
+    appendHistogram(out, extensions_name, "", extensions, 1.0);
+
+    const std::string stage_name = name + "_stage_duration_seconds";
+    appendHeader(out, stage_name, "Time spent in each parsing stage.", "histogram");
+    appendHistogram(out, stage_name, "stage=\"header_split\"", header_split, 1e9);
+    appendHistogram(out, stage_name, "stage=\"extension_tokenize\"", extension_tokenize,
+                    1e9);
+    appendHistogram(out, stage_name, "stage=\"unescape\"", unescape, 1e9);
+
+    return out;
+}
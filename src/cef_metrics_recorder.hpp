@@ -0,0 +1,118 @@
+#ifndef CEF_CPP_CEF_METRICS_RECORDER_H
+#define CEF_CPP_CEF_METRICS_RECORDER_H
+
+#include "cef_metrics.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace cef_cpp::detail {
+
+enum class Stage : uint8_t {
+    HeaderSplit,
+    ExtensionTokenize,
+    Unescape
+};
+
+inline constexpr size_t kStageCount = 3;
+
+struct AtomicHistogram {
+    std::array<std::atomic<uint64_t>, Histogram::kBuckets> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+};
+
+/**
+ * @brief Counters of one thread
+ *
+ * Only the owning thread writes them, so increments are plain loads and stores; the
+ * atomics make concurrent snapshots well-defined.
+ */
+struct ThreadMetrics {
+    std::atomic<uint64_t> lines{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> events{0};
+    std::array<std::atomic<uint64_t>, kParseErrorCodeCount> errors{};
+    AtomicHistogram extensions;
+    std::array<AtomicHistogram, kStageCount> stages;
+
+    ThreadMetrics();
+    ~ThreadMetrics();
+};
+
+ThreadMetrics& threadMetrics();
+
+inline void increment(std::atomic<uint64_t>& counter, const uint64_t value = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+inline void record(AtomicHistogram& histogram, const uint64_t value, const uint64_t first_bound) {
+    increment(histogram.buckets[Histogram::bucketFor(value, first_bound)]);
+    increment(histogram.count);
+    increment(histogram.sum, value);
+}
+
+/**
+ * @brief Record a line that was rejected
+ */
+inline void recordError(const size_t bytes, const ParseErrorCode code) {
+    if constexpr (Metrics::kEnabled) {
+        ThreadMetrics& metrics = threadMetrics();
+        increment(metrics.lines);
+        increment(metrics.bytes, bytes);
+        increment(metrics.errors[static_cast<size_t>(code)]);
+    }
+}
+
+/**
+ * @brief Record the outcome of parsing one line
+ */
+template <typename View>
+void recordLine(const size_t bytes, const std::optional<ParseError>& error,
+                const View& view) {
+    if constexpr (Metrics::kEnabled) {
+        if (error) {
+            recordError(bytes, error->code);
+            return;
+        }
+        ThreadMetrics& metrics = threadMetrics();
+        increment(metrics.lines);
+        increment(metrics.bytes, bytes);
+        increment(metrics.events);
+        record(metrics.extensions, view.getRawExtensions().size(), 1);
+    }
+}
+
+/**
+ * @brief Records the time from construction to destruction as a stage latency
+ *
+ * An empty object unless metrics are enabled.
+ */
+class StageTimer {
+public:
+#if CEF_CPP_METRICS
+    explicit StageTimer(const Stage stage)
+        : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+
+    ~StageTimer() {
+        const auto elapsed = std::chrono::steady_clock::now() - start_;
+        record(threadMetrics().stages[static_cast<size_t>(stage_)],
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 32);
+    }
+#else
+    explicit StageTimer(Stage) {}
+#endif
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+#if CEF_CPP_METRICS
+private:
+    Stage stage_;
+    std::chrono::steady_clock::time_point start_;
+#endif
+};
+
+} // namespace cef_cpp::detail
+
+#endif
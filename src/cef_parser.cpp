@@ -1,99 +1,226 @@
 #include "cef_parser.hpp"
-
-#include <boost/algorithm/string.hpp>
-#include <boost/regex.hpp>
+#include "cef_event_batch.hpp"
+#include "cef_mapped_file.hpp"
+#include "cef_metrics_recorder.hpp"
+#include "cef_scanner.hpp"
+#include "cef_thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <exception>
 #include <iostream>
+#include <iterator>
+#include <thread>
 
 using namespace cef_cpp;
 
-Event Parser::parse(const std::string& cef_line) {
+std::string ParseError::message() const {
+    return std::string(codeToString(code)) + " (at byte " + std::to_string(offset) + ")";
+}
+
+const char* ParseError::codeToString(const ParseErrorCode code) {
+    switch (code) {
+    case ParseErrorCode::EmptyLine:
+        return "Empty CEF line";
+    case ParseErrorCode::MissingPrefix:
+        return "Line does not start with 'CEF:'";
+    case ParseErrorCode::TooFewFields:
+        return "Invalid CEF format: expected at least 7 fields (Version|Vendor|Product|DeviceVersion|ClassID|Name|Severity)";
+    case ParseErrorCode::EmptyField:
+        return "Invalid CEF header: required field is empty";
+    case ParseErrorCode::InvalidVersion:
+        return "Invalid CEF version";
+    case ParseErrorCode::InvalidSeverity:
+        return "Invalid CEF severity";
+    case ParseErrorCode::InvalidSyslogHeader:
+        return "Invalid syslog header or no CEF payload";
+    case ParseErrorCode::Filtered:
+        return "Event rejected by filter";
+    default:
+        return "Unknown parse error";
+    }
+}
+
+Event Parser::parse(const std::string& cef_line, const ParseOptions& options) {
+    return std::move(tryParse(cef_line, options).value());
+}
+
+EventView Parser::parseView(const std::string_view cef_line) {
+    return std::move(tryParseView(cef_line).value());
+}
+
+ParseResult<Event> Parser::tryParse(const std::string_view cef_line,
+                                    const ParseOptions& options) {
+    const auto view = tryParseView(cef_line, options);
+    if (!view) {
+        return view.error();
+    }
+    return view->toEvent(options.lazy_extensions, options.projection.get());
+}
+
+ParseResult<EventView> Parser::tryParseView(const std::string_view cef_line,
+                                            std::pmr::memory_resource* resource) {
+    return parseCef(cef_line, resource, nullptr);
+}
+
+ParseResult<EventView> Parser::parseCef(const std::string_view cef_line,
+                                        std::pmr::memory_resource* resource,
+                                        const Filter* filter) {
+    EventView event(resource);
+    if (const auto error = parseCefInto(cef_line, filter, event)) {
+        return *error;
+    }
+    return event;
+}
+
+std::optional<ParseError> Parser::parseCefInto(const std::string_view cef_line,
+                                               const Filter* filter, EventView& event) {
+    const auto error = scanCef(cef_line, filter, event);
+    detail::recordLine(cef_line.size(), error, event);
+    return error;
+}
+
+std::optional<ParseError> Parser::scanCef(const std::string_view cef_line,
+                                          const Filter* filter, EventView& event) {
+    // A reused view keeps the capacity of its extension index
+    event.extensions_.clear();
+    event.extension_part_ = {};
+    event.syslog_header_ = {};
+
     if (cef_line.empty()) {
-        throw ParseException("Empty CEF line");
+        return ParseError{ParseErrorCode::EmptyLine};
     }
 
     // Check if line starts with CEF:
-    if (cef_line.substr(0, 4) != "CEF:") {
-        throw ParseException("Line does not start with 'CEF:'");
+    if (!cef_line.starts_with("CEF:")) {
+        return ParseError{ParseErrorCode::MissingPrefix};
     }
 
-    // Remove the CEF: prefix
-    std::string content = cef_line.substr(4);
+    // Skip the CEF: prefix
+    const std::string_view content = cef_line.substr(4);
 
     // CEF Format: Version|Device Vendor|Device Product|Device Version|Device Event Class ID|Name|Severity|Extension
-    // We need to split this carefully, as the extension part is optional and contains the last |
+    // The extension part is optional and may itself contain pipes
+    // Header splitting and extension tokenizing share one structural index of the line
+    detail::StructuralIndex index(content);
+    std::array<std::string_view, 7> header_fields;
+    std::string_view extension_part;
+    int severity = 0;
+    {
+        detail::StageTimer timer(detail::Stage::HeaderSplit);
+        const size_t field_count = splitHeader(index, header_fields, extension_part);
+
+        // We need 7 parts: Version, Vendor, Product, DeviceVersion, ClassID, Name, Severity
+        if (field_count < 7) {
+            return ParseError{ParseErrorCode::TooFewFields, cef_line.size()};
+        }
 
-    // First, let's split by pipes, but be careful about the last field
-    std::vector<std::string> all_parts;
-    std::string current_part;
+        // Validate header fields
+        if (const auto error = validateHeaderFields(cef_line, header_fields)) {
+            return *error;
+        }
 
-    for (size_t i = 0; i < content.length(); ++i) {
-        char c = content[i];
+        if (!parseHeaderInt(header_fields[0], event.version_)) {
+            return ParseError{ParseErrorCode::InvalidVersion, 4};
+        }
 
-        if (c == '|' && (i == 0 || content[i - 1] != '\\')) {
-            all_parts.push_back(current_part);
-            current_part.clear();
-        } else {
-            current_part += c;
+        if (!parseHeaderInt(header_fields[6], severity)) {
+            return ParseError{ParseErrorCode::InvalidSeverity,
+                              static_cast<size_t>(header_fields[6].data() - cef_line.data())};
         }
     }
 
-    // Add the last part
-    all_parts.push_back(current_part);
-
-    // Now we should have at least 7 parts: Version, Vendor, Product, DeviceVersion, ClassID, Name, Severity[, Extensions]
-    if (all_parts.size() < 7) {
-        throw ParseException(
-            "Invalid CEF format: expected at least 7 fields (Version|Vendor|Product|DeviceVersion|ClassID|Name|Severity), got "
-            +
-            std::to_string(all_parts.size()));
+    event.device_vendor_ = header_fields[1];
+    event.device_product_ = header_fields[2];
+    event.device_version_ = header_fields[3];
+    event.device_event_class_id_ = header_fields[4];
+    event.name_ = header_fields[5];
+    event.severity_ = Event::toSeverity(severity);
+
+    // Reject on the header alone before the rest of the line is indexed
+    Filter::Match match = Filter::Match::True;
+    if (filter != nullptr) {
+        match = filter->evaluate(event, false);
+        if (match == Filter::Match::False) {
+            return ParseError{ParseErrorCode::Filtered};
+        }
     }
 
-    // Extract header fields (first 7)
-    std::vector<std::string> header_fields(all_parts.begin(), all_parts.begin() + 7);
+    // Record extensions if present; they stay escaped until read
+    event.extension_part_ = extension_part;
+    {
+        detail::StageTimer timer(detail::Stage::ExtensionTokenize);
+        detail::forEachExtension(index,
+                                 extension_part.data() - content.data(),
+                                 [&](const std::string_view key, const std::string_view value) {
+                                     event.extensions_.emplace_back(key, value);
+                                 });
+    }
 
-    // Everything after the 7th field is extensions
-    std::string extension_part;
-    if (all_parts.size() > 7) {
-        // Reconstruct extension part by joining remaining parts with |
-        for (size_t i = 7; i < all_parts.size(); ++i) {
-            if (i > 7)
-                extension_part += "|";
-            extension_part += all_parts[i];
-        }
+    if (match == Filter::Match::Unknown &&
+        filter->evaluate(event, true) != Filter::Match::True) {
+        return ParseError{ParseErrorCode::Filtered};
     }
 
-    // Validate header fields
-    validateHeaderFieldCount(header_fields);
+    return std::nullopt;
+}
 
-    // Create and populate event
-    Event event;
+ParseResult<EventView> Parser::tryParseSyslog(const std::string_view line,
+                                              std::pmr::memory_resource* resource) {
+    return parseSyslog(line, resource, nullptr);
+}
 
-    try {
-        // Parse version
-        event.setVersion(std::stoi(header_fields[0]));
+ParseResult<EventView> Parser::parseSyslog(const std::string_view line,
+                                           std::pmr::memory_resource* resource,
+                                           const Filter* filter) {
+    EventView event(resource);
+    if (const auto error = parseSyslogInto(line, filter, event)) {
+        return *error;
+    }
+    return event;
+}
 
-        // Set header fields (unescape them)
-        event.setDeviceVendor(unescapeString(header_fields[1]));
-        event.setDeviceProduct(unescapeString(header_fields[2]));
-        event.setDeviceVersion(unescapeString(header_fields[3]));
-        event.setDeviceEventClassId(unescapeString(header_fields[4]));
-        event.setName(unescapeString(header_fields[5]));
+std::optional<ParseError> Parser::parseSyslogInto(const std::string_view line,
+                                                  const Filter* filter, EventView& event) {
+    if (line.empty()) {
+        return ParseError{ParseErrorCode::EmptyLine};
+    }
 
-        // Parse severity
-        event.setSeverity(std::stoi(header_fields[6]));
-    } catch (const std::exception& e) {
-        throw ParseException("Error parsing CEF header fields: " + std::string(e.what()));
+    SyslogHeader header;
+    std::string_view payload;
+    if (!splitSyslogLine(line, header, payload)) {
+        // Lines without a CEF payload are counted here, the rest by parseCefInto
+        detail::recordError(line.size(), ParseErrorCode::InvalidSyslogHeader);
+        return ParseError{ParseErrorCode::InvalidSyslogHeader};
     }
 
-    // Parse extensions if present
-    if (!extension_part.empty()) {
-        auto extensions = parseExtensions(extension_part);
-        for (const auto& [key, value] : extensions) {
-            event.setExtension(key, value);
-        }
+    if (auto error = parseCefInto(payload, filter, event)) {
+        error->offset += payload.data() - line.data();
+        return error;
     }
+    event.syslog_header_ = header;
+    return std::nullopt;
+}
 
-    return event;
+ParseResult<EventView> Parser::tryParseView(const std::string_view line,
+                                            const ParseOptions& options,
+                                            std::pmr::memory_resource* resource) {
+    return options.syslog ? parseSyslog(line, resource, options.filter.get())
+                          : parseCef(line, resource, options.filter.get());
+}
+
+Parser::Parser(ParseOptions options) : options_(std::move(options)) {
+}
+
+std::optional<ParseError> Parser::parseInto(const std::string_view line, Event& event) {
+    const Filter* filter = options_.filter.get();
+    if (const auto error = options_.syslog ? parseSyslogInto(line, filter, view_)
+                                           : parseCefInto(line, filter, view_)) {
+        return error;
+    }
+    view_.copyTo(event, options_.lazy_extensions, options_.projection.get());
+    return std::nullopt;
 }
 
 std::vector<Event> Parser::parseMultiple(const std::vector<std::string>& cef_lines) {
@@ -101,191 +228,461 @@ std::vector<Event> Parser::parseMultiple(const std::vector<std::string>& cef_lin
     events.reserve(cef_lines.size());
 
     for (size_t i = 0; i < cef_lines.size(); ++i) {
-        try {
-            events.push_back(parse(cef_lines[i]));
-        } catch (const ParseException& e) {
-            throw ParseException(
-                "Error parsing line " + std::to_string(i + 1) + ": " + e.what());
+        auto event = tryParse(cef_lines[i]);
+        if (!event) {
+            throw ParseException("Error parsing line " + std::to_string(i + 1) + ": " +
+                                 event.error().message());
         }
+        events.push_back(std::move(*event));
     }
 
     return events;
 }
 
-std::vector<Event> Parser::parseFromString(const std::string& cef_log) {
-    std::vector<std::string> lines;
-    boost::split(lines, cef_log, boost::is_any_of("\n\r"));
+std::vector<Event> Parser::parseMultiple(const std::vector<std::string>& cef_lines,
+                                         std::vector<LineError>& errors,
+                                         const ParseOptions& options) {
+    std::vector<Event> events;
+    events.reserve(cef_lines.size());
 
-    // Remove empty lines
-    std::erase_if(lines,
-                  [](const std::string& line) {
-                      return boost::trim_copy(line).empty();
-                  });
+    for (size_t i = 0; i < cef_lines.size(); ++i) {
+        auto event = tryParse(cef_lines[i], options);
+        if (!event) {
+            if (event.error().code != ParseErrorCode::Filtered) {
+                errors.push_back({i + 1, event.error()});
+            }
+            continue;
+        }
+        events.push_back(std::move(*event));
+    }
 
-    return parseMultiple(lines);
+    return events;
 }
 
-bool Parser::isValidCEF(const std::string& cef_line) {
-    try {
-        parse(cef_line);
-        return true;
-    } catch (const ParseException&) {
-        return false;
+std::vector<Event> Parser::parseMultiple(const std::vector<std::string>& cef_lines,
+                                         ThreadPool& pool,
+                                         const ParseOptions& options) {
+    std::vector<LineError> errors;
+    auto events = parseParallel(cef_lines, errors, pool, options);
+    if (!errors.empty()) {
+        throw ParseException("Error parsing line " + std::to_string(errors[0].line_number) +
+                             ": " + errors[0].error.message());
     }
+    return events;
 }
 
-std::vector<std::string> Parser::splitHeader(const std::string& header_part) {
-    std::vector<std::string> fields;
-    std::string current_field;
+std::vector<Event> Parser::parseMultiple(const std::vector<std::string>& cef_lines,
+                                         std::vector<LineError>& errors,
+                                         ThreadPool& pool,
+                                         const ParseOptions& options) {
+    return parseParallel(cef_lines, errors, pool, options);
+}
+
+std::vector<Event> Parser::parseParallel(const std::vector<std::string>& cef_lines,
+                                         std::vector<LineError>& errors,
+                                         ThreadPool& pool,
+                                         const ParseOptions& options) {
+    // Every line owns one output slot, so workers never contend for the results
+    std::vector<Event> events(cef_lines.size());
+    std::vector<std::optional<ParseError>> line_errors(cef_lines.size());
+    std::atomic<bool> failed{false};
+
+    constexpr size_t grain_size = 128;
+    pool.parallelFor(cef_lines.size(), grain_size, [&](const size_t begin, const size_t end) {
+        bool chunk_failed = false;
+        for (size_t i = begin; i < end; ++i) {
+            auto event = tryParse(cef_lines[i], options);
+            if (event) {
+                events[i] = std::move(*event);
+            } else {
+                line_errors[i] = event.error();
+                chunk_failed = true;
+            }
+        }
+        if (chunk_failed) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
 
-    for (size_t i = 0; i < header_part.length(); ++i) {
-        char c = header_part[i];
+    if (!failed) {
+        return events;
+    }
 
-        if (c == '|' && (i == 0 || header_part[i - 1] != '\\')) {
-            fields.push_back(current_field);
-            current_field.clear();
+    // Close the gaps left by malformed and filtered lines
+    size_t kept = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (line_errors[i]) {
+            if (line_errors[i]->code != ParseErrorCode::Filtered) {
+                errors.push_back({i + 1, *line_errors[i]});
+            }
         } else {
-            current_field += c;
+            if (kept != i) {
+                events[kept] = std::move(events[i]);
+            }
+            ++kept;
         }
     }
+    events.resize(kept);
+    return events;
+}
 
-    // Add the last field (severity)
-    fields.push_back(current_field);
+namespace {
 
-    // Debug output for troubleshooting
-#ifdef DEBUG
-    std::cout << "DEBUG: Split header into " << fields.size() << " fields:" << std::endl;
-    for (size_t i = 0; i < fields.size(); ++i) {
-        std::cout << "  Field " << i << ": '" << fields[i] << "'" << std::endl;
+// Size the first arena block to hold every line plus its views in one go
+EventBatch makeBatch(const std::vector<std::string>& cef_lines) {
+    size_t bytes = 0;
+    for (const auto& line : cef_lines) {
+        bytes += line.size() + sizeof(EventView);
     }
-#endif
 
-    return fields;
+    EventBatch batch(bytes + EventBatch::kDefaultArenaSize);
+    batch.reserve(cef_lines.size());
+    return batch;
 }
 
-std::unordered_map<std::string, std::string> Parser::parseExtensions(
-    const std::string& extension_part) {
-    std::unordered_map<std::string, std::string> extensions;
+} // namespace
+
+EventBatch Parser::parseBatch(const std::vector<std::string>& cef_lines,
+                              const ParseOptions& options) {
+    auto batch = makeBatch(cef_lines);
+
+    for (size_t i = 0; i < cef_lines.size(); ++i) {
+        const auto added = batch.tryAdd(cef_lines[i], options);
+        if (!added && added.error().code != ParseErrorCode::Filtered) {
+            throw ParseException("Error parsing line " + std::to_string(i + 1) + ": " +
+                                 added.error().message());
+        }
+    }
+
+    return batch;
+}
 
-    if (extension_part.empty()) {
-        return extensions;
+EventBatch Parser::parseBatch(const std::vector<std::string>& cef_lines,
+                              std::vector<LineError>& errors,
+                              const ParseOptions& options) {
+    auto batch = makeBatch(cef_lines);
+
+    for (size_t i = 0; i < cef_lines.size(); ++i) {
+        const auto added = batch.tryAdd(cef_lines[i], options);
+        if (!added && added.error().code != ParseErrorCode::Filtered) {
+            errors.push_back({i + 1, added.error()});
+        }
     }
 
-    // Use regex to parse key=value pairs, handling escaped characters
-    const boost::regex extension_regex(R"((\w+)=((?:\\.|(?!\s+\w+=).)*))");
-    boost::sregex_iterator iter(extension_part.begin(),
-                                extension_part.end(),
-                                extension_regex);
-    boost::sregex_iterator end;
+    return batch;
+}
 
-    for (; iter != end; ++iter) {
-        const boost::smatch& match = *iter;
-        std::string key = match[1].str();
-        std::string value = boost::trim_copy(match[2].str());
+std::vector<Event> Parser::parseFromString(const std::string& cef_log) {
+    std::vector<LineError> errors;
+    auto events = parseText(cef_log, errors, nullptr, {});
+    if (!errors.empty()) {
+        throw ParseException("Error parsing line " + std::to_string(errors[0].line_number) +
+                             ": " + errors[0].error.message());
+    }
+    return events;
+}
 
-        // Unescape the value
-        value = unescapeString(value);
+std::vector<Event> Parser::parseFromString(const std::string& cef_log,
+                                           std::vector<LineError>& errors,
+                                           const ParseOptions& options) {
+    return parseText(cef_log, errors, nullptr, options);
+}
 
-        extensions[key] = value;
+std::vector<Event> Parser::parseFromString(const std::string& cef_log,
+                                           ThreadPool& pool,
+                                           const ParseOptions& options) {
+    std::vector<LineError> errors;
+    auto events = parseText(cef_log, errors, &pool, options);
+    if (!errors.empty()) {
+        throw ParseException("Error parsing line " + std::to_string(errors[0].line_number) +
+                             ": " + errors[0].error.message());
     }
+    return events;
+}
 
-    return extensions;
+std::vector<Event> Parser::parseFromString(const std::string& cef_log,
+                                           std::vector<LineError>& errors,
+                                           ThreadPool& pool,
+                                           const ParseOptions& options) {
+    return parseText(cef_log, errors, &pool, options);
 }
 
-std::string Parser::unescapeString(const std::string& str) {
-    std::string result;
-    result.reserve(str.length());
-
-    for (size_t i = 0; i < str.length(); ++i) {
-        if (str[i] == '\\' && i + 1 < str.length()) {
-            char next = str[i + 1];
-            switch (next) {
-            case '\\':
-                result += '\\';
-                break;
-            case '|':
-                result += '|';
-                break;
-            case '=':
-                result += '=';
-                break;
-            case 'n':
-                result += '\n';
-                break;
-            case 'r':
-                result += '\r';
-                break;
-            case 't':
-                result += '\t';
-                break;
-            default:
-                result += '\\';
-                result += next;
-                break;
+namespace {
+
+// Multi-line strings are parsed in chunks of about this many bytes: large enough to
+// amortize scheduling, small enough for idle threads to steal around long lines
+constexpr size_t text_chunk_size = 256 * 1024;
+
+// Shorter strings without a thread pool are parsed on the calling thread
+constexpr size_t min_parallel_text_size = 1024 * 1024;
+
+// Pool for strings parsed without one, started on first use so repeated calls do not
+// pay for starting threads; leaked on purpose, like StringTable::global(), so no late
+// call can outlive it
+ThreadPool& sharedTextPool() {
+    static ThreadPool* pool = new ThreadPool();
+    return *pool;
+}
+
+// Results of one chunk; errors are kept with the offset of their line
+struct TextChunk {
+    std::vector<Event> events;
+    std::vector<std::pair<size_t, ParseError>> errors;
+};
+
+} // namespace
+
+std::vector<Event> Parser::parseText(const std::string_view text,
+                                     std::vector<LineError>& errors,
+                                     ThreadPool* pool,
+                                     const ParseOptions& options) {
+    if (pool == nullptr && text.size() >= min_parallel_text_size) {
+        pool = &sharedTextPool();
+    }
+
+    // Chunks are views of whole lines, so no line is copied before it is parsed
+    const auto ranges =
+        detail::partitionLines(text, pool != nullptr ? text.size() / text_chunk_size + 1 : 1);
+    std::vector<TextChunk> chunks(ranges.size());
+
+    const auto parse_chunk = [&](const size_t index) {
+        const std::string_view range = ranges[index];
+        TextChunk& chunk = chunks[index];
+        chunk.events.reserve(std::count(range.begin(), range.end(), '\n') + 1);
+
+        Parser parser(options);
+        detail::forEachLine(range, [&](const std::string_view line) {
+            Event& event = chunk.events.emplace_back();
+            if (const auto error = parser.parseInto(line, event)) {
+                chunk.events.pop_back();
+                if (error->code != ParseErrorCode::Filtered) {
+                    chunk.errors.emplace_back(line.data() - text.data(), *error);
+                }
             }
-            ++i; // Skip the next character
-        } else {
-            result += str[i];
+            return true;
+        });
+    };
+
+    if (pool != nullptr && chunks.size() > 1) {
+        pool->parallelFor(chunks.size(), 1, [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                parse_chunk(i);
+            }
+        });
+    } else {
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            parse_chunk(i);
         }
     }
 
-    return result;
+    // Number the errors by counting newlines up to each in one pass over the text
+    size_t line_number = 1;
+    const char* counted = text.data();
+    for (const TextChunk& chunk : chunks) {
+        for (const auto& [offset, error] : chunk.errors) {
+            line_number += std::count(counted, text.data() + offset, '\n');
+            counted = text.data() + offset;
+            errors.push_back({line_number, error});
+        }
+    }
+
+    if (chunks.size() == 1) {
+        return std::move(chunks[0].events);
+    }
+    size_t total = 0;
+    for (const TextChunk& chunk : chunks) {
+        total += chunk.events.size();
+    }
+    std::vector<Event> events;
+    events.reserve(total);
+    for (TextChunk& chunk : chunks) {
+        std::move(chunk.events.begin(), chunk.events.end(), std::back_inserter(events));
+    }
+    return events;
 }
 
-std::string Parser::escapeString(const std::string& str) {
-    std::string result;
-    result.reserve(str.length() * 2); // Rough estimate
-
-    for (char c : str) {
-        switch (c) {
-        case '\\':
-            result += "\\\\";
-            break;
-        case '|':
-            result += "\\|";
-            break;
-        case '=':
-            result += "\\=";
-            break;
-        case '\n':
-            result += "\\n";
-            break;
-        case '\r':
-            result += "\\r";
-            break;
-        case '\t':
-            result += "\\t";
-            break;
-        default:
-            result += c;
-            break;
+size_t Parser::parseFile(const std::string& path,
+                         const std::function<void(Event&&)>& callback,
+                         size_t thread_count,
+                         const ParseOptions& options) {
+    const detail::MappedFile file(path);
+    const std::string_view data = file.data();
+
+    // Avoid spawning threads for ranges too small to amortize them
+    constexpr size_t min_range_size = 1024 * 1024;
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    thread_count = std::clamp<size_t>(data.size() / min_range_size, 1, thread_count);
+
+    const auto ranges = detail::partitionLines(data, thread_count);
+    std::vector<size_t> counts(ranges.size(), 0);
+    std::vector<std::optional<ParseError>> parse_errors(ranges.size());
+    std::vector<size_t> error_offsets(ranges.size(), 0);
+    std::vector<std::exception_ptr> exceptions(ranges.size());
+    std::atomic<bool> failed{false};
+
+    const auto parse_range = [&](const size_t index) {
+        size_t count = 0;
+        try {
+            detail::forEachLine(ranges[index], [&](const std::string_view line) {
+                if (failed.load(std::memory_order_relaxed)) {
+                    return false;
+                }
+                const auto view = tryParseView(line, options);
+                if (!view && view.error().code == ParseErrorCode::Filtered) {
+                    return true;
+                }
+                if (!view) {
+                    parse_errors[index] = view.error();
+                    error_offsets[index] = line.data() - data.data();
+                    failed = true;
+                    return false;
+                }
+                callback(
+                    view->toEvent(options.lazy_extensions, options.projection.get()));
+                ++count;
+                return true;
+            });
+        } catch (...) {
+            exceptions[index] = std::current_exception();
+            failed = true;
+        }
+        counts[index] = count;
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(ranges.size());
+        for (size_t i = 1; i < ranges.size(); ++i) {
+            workers.emplace_back(parse_range, i);
+        }
+        if (!ranges.empty()) {
+            parse_range(0);
+        }
+    }
+
+    // Report the first failing range, translating parse errors to a line number
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (exceptions[i]) {
+            std::rethrow_exception(exceptions[i]);
+        }
+        if (parse_errors[i]) {
+            const auto line = std::count(data.begin(), data.begin() + error_offsets[i], '\n');
+            throw ParseException("Error parsing line " + std::to_string(line + 1) + ": " +
+                                 parse_errors[i]->message());
+        }
+    }
+
+    size_t total = 0;
+    for (const size_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+bool Parser::isValidCEF(const std::string& cef_line) {
+    return tryParseView(cef_line).hasValue();
+}
+
+size_t Parser::splitHeader(detail::StructuralIndex& index,
+                          std::array<std::string_view, 7>& fields,
+                          std::string_view& extension_part) {
+    const std::string_view content = index.text();
+    size_t field_count = 0;
+    size_t field_begin = 0;
+
+    // Jump from pipe to pipe using the structural index. A backslash escapes the
+    // character after it, so a pipe is a delimiter unless an odd run of backslashes
+    // precedes it: in `\\|` the backslash is escaped and the pipe is not. Runs never
+    // extend past the previous delimiter, so the look-back stays linear overall.
+    for (size_t i = index.next(0, detail::StructuralIndex::Pipe);
+         i < content.length() && field_count < fields.size();
+         i = index.next(i + 1, detail::StructuralIndex::Pipe)) {
+        size_t backslash = i;
+        while (backslash > field_begin && content[backslash - 1] == '\\') {
+            --backslash;
+        }
+        if ((i - backslash) % 2 == 0) {
+            fields[field_count++] = content.substr(field_begin, i - field_begin);
+            field_begin = i + 1;
         }
     }
 
+    // Whatever follows the 7th delimiter is the extension part, otherwise the rest of
+    // the line is the last header field (severity)
+    if (field_count == fields.size()) {
+        extension_part = content.substr(field_begin);
+    } else {
+        fields[field_count++] = content.substr(field_begin);
+        extension_part = content.substr(content.length());
+    }
+
+    // Debug output for troubleshooting
+#ifdef DEBUG
+    std::cout << "DEBUG: Split header into " << field_count << " fields:" << std::endl;
+    for (size_t i = 0; i < field_count; ++i) {
+        std::cout << "  Field " << i << ": '" << fields[i] << "'" << std::endl;
+    }
+#endif
+
+    return field_count;
+}
+
+bool Parser::parseHeaderInt(const std::string_view field, int& value) {
+    // Accept what std::stoi accepts: leading whitespace, an optional sign and
+    // trailing characters after the number
+    std::string_view digits = field;
+    while (!digits.empty() && detail::isSpaceChar(digits.front())) {
+        digits.remove_prefix(1);
+    }
+    if (digits.starts_with('+')) {
+        digits.remove_prefix(1);
+    }
+
+    const auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    return ec == std::errc();
+}
+
+std::unordered_map<std::string, std::string> Parser::parseExtensions(
+    const std::string& extension_part,
+    const Projection* projection) {
+    std::unordered_map<std::string, std::string> extensions;
+
+    detail::forEachExtension(extension_part,
+                             [&](const std::string_view key, const std::string_view value) {
+                                 if (projection == nullptr ||
+                                     projection->containsExtension(key)) {
+                                     extensions[std::string(key)] = unescapeString(value);
+                                 }
+                             });
+
+    return extensions;
+}
+
+std::string Parser::unescapeString(const std::string_view str) {
+    return detail::unescape(str);
+}
+
+std::string Parser::escapeString(const std::string& str) {
+    const size_t size = detail::escapedSize(str, detail::ValueEscapeClass);
+    if (size == str.size()) {
+        return str;
+    }
+    std::string result(size, '\0');
+    detail::writeEscaped(str, detail::ValueEscapeClass, result.data());
     return result;
 }
 
-void Parser::validateHeaderFieldCount(const std::vector<std::string>& fields) {
-    if (fields.size() != 7) {
-        throw ParseException(
-            "Invalid CEF header: expected 7 fields (Version|Vendor|Product|Version|ClassID|Name|Severity), got "
-            +
-            std::to_string(fields.size()) + " fields");
-    }
-
-    // Additional validation for empty required fields
-    if (fields[0].empty())
-        throw ParseException("CEF Version cannot be empty");
-    if (fields[1].empty())
-        throw ParseException("Device Vendor cannot be empty");
-    if (fields[2].empty())
-        throw ParseException("Device Product cannot be empty");
-    if (fields[3].empty())
-        throw ParseException("Device Version cannot be empty");
-    if (fields[4].empty())
-        throw ParseException("Device Event Class ID cannot be empty");
-    if (fields[5].empty())
-        throw ParseException("Event Name cannot be empty");
-    if (fields[6].empty())
-        throw ParseException("Severity cannot be empty");
+std::optional<ParseError> Parser::validateHeaderFields(
+    const std::string_view cef_line,
+    const std::array<std::string_view, 7>& fields) {
+    // All header fields are required
+    for (const auto& field : fields) {
+        if (field.empty()) {
+            return ParseError{ParseErrorCode::EmptyField,
+                              static_cast<size_t>(field.data() - cef_line.data())};
+        }
+    }
+    return std::nullopt;
 }
@@ -0,0 +1,32 @@
+#include "cef_projection.hpp"
+#include "cef_extension_keys.hpp"
+
+#include <algorithm>
+#include <functional>
+
+using namespace cef_cpp;
+
+Projection::Projection(const std::vector<std::string>& extension_keys,
+                       const std::initializer_list<HeaderField> header_fields) {
+    for (const HeaderField field : header_fields) {
+        header_fields_ |= 1u << static_cast<unsigned>(field);
+    }
+
+    extension_keys_.reserve(extension_keys.size());
+    for (const std::string& key : extension_keys) {
+        extension_keys_.emplace_back(toExtensionKeyName(key));
+    }
+    std::sort(extension_keys_.begin(), extension_keys_.end());
+    extension_keys_.erase(std::unique(extension_keys_.begin(), extension_keys_.end()),
+                          extension_keys_.end());
+}
+
+bool Projection::containsExtension(const std::string_view key) const {
+    // Projections are usually a handful of keys, for which a scan beats a search
+    if (extension_keys_.size() <= 8) {
+        return std::find(extension_keys_.begin(), extension_keys_.end(), key) !=
+               extension_keys_.end();
+    }
+    return std::binary_search(extension_keys_.begin(), extension_keys_.end(), key,
+                              std::less<>());
+}
@@ -0,0 +1,105 @@
+#ifndef CEF_CPP_CEF_RING_BUFFER_H
+#define CEF_CPP_CEF_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace cef_cpp::detail {
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer queue
+ *
+ * Every slot carries a sequence number telling producers and consumers whose turn it
+ * is, so a push or pop costs one compare-and-swap on the shared position and touches
+ * no other slot. Slots are reused in place: push and pop hand the slot's value to a
+ * callback instead of copying it, so values such as std::string keep their capacity
+ * across laps and the steady state does not allocate.
+ */
+template <typename T>
+class MpmcRingBuffer {
+public:
+    // @p capacity is rounded up to a power of two
+    explicit MpmcRingBuffer(const size_t capacity)
+        : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+          slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * @brief Claim a free slot and let @p fill(T&) write it
+     *
+     * @return false if the queue is full
+     */
+    template <typename Fill>
+    bool tryPush(Fill&& fill) {
+        size_t pos = push_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (push_pos_.compare_exchange_weak(pos, pos + 1,
+                                                    std::memory_order_relaxed)) {
+                    fill(slot.value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = push_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Take the oldest slot and let @p consume(T&) read it
+     *
+     * @return false if the queue is empty
+     */
+    template <typename Consume>
+    bool tryPop(Consume&& consume) {
+        size_t pos = pop_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (pop_pos_.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed)) {
+                    consume(slot.value);
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = pop_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // Producer and consumer positions live on separate cache lines
+    alignas(64) std::atomic<size_t> push_pos_{0};
+    alignas(64) std::atomic<size_t> pop_pos_{0};
+};
+
+} // namespace cef_cpp::detail
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef CEF_CPP_CEF_SCANNER_H
+#define CEF_CPP_CEF_SCANNER_H
+
+#include "cef_structural_index.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cef_cpp::detail {
+
+enum CharClass : uint8_t {
+    WordClass = 1u << 0,
+    SpaceClass = 1u << 1,
+    // Characters escaped when serializing header fields and extension values
+    HeaderEscapeClass = 1u << 2,
+    ExtensionEscapeClass = 1u << 3,
+    // Characters escaped by Parser::escapeString, which also escapes tabs
+    ValueEscapeClass = 1u << 4
+};
+
+constexpr std::array<uint8_t, 256> makeCharClasses() {
+    std::array<uint8_t, 256> classes{};
+    for (int c = 0; c < 256; ++c) {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '_') {
+            classes[c] = WordClass;
+        } else if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            classes[c] = SpaceClass;
+        }
+    }
+    for (const char c : {'\\', '\n', '\r'}) {
+        classes[static_cast<unsigned char>(c)] |= HeaderEscapeClass | ExtensionEscapeClass;
+    }
+    classes['|'] |= HeaderEscapeClass;
+    classes['='] |= ExtensionEscapeClass;
+    for (const char c : {'\\', '|', '=', '\n', '\r', '\t'}) {
+        classes[static_cast<unsigned char>(c)] |= ValueEscapeClass;
+    }
+    return classes;
+}
+
+inline constexpr std::array<uint8_t, 256> kCharClasses = makeCharClasses();
+
+/**
+ * @brief Matches the regex class \w in the C locale (alphanumeric or underscore)
+ */
+constexpr bool isWordChar(const char c) {
+    return kCharClasses[static_cast<unsigned char>(c)] & WordClass;
+}
+
+/**
+ * @brief Matches the regex class \s in the C locale
+ */
+constexpr bool isSpaceChar(const char c) {
+    return kCharClasses[static_cast<unsigned char>(c)] & SpaceClass;
+}
+
+/**
+ * @brief Strip leading and trailing whitespace from a view
+ */
+constexpr std::string_view trim(std::string_view str) {
+    while (!str.empty() && isSpaceChar(str.front())) {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && isSpaceChar(str.back())) {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+/**
+ * @brief Append the unescaped form of a CEF field or value to @p out
+ *
+ * Recognizes \\, \|, \=, \n, \r and \t; any other backslash sequence is kept as is.
+ * Most fields contain no backslash at all and are appended in one copy; otherwise the
+ * runs between backslashes, found with memchr, are copied in bulk.
+ */
+inline void appendUnescaped(const std::string_view str, std::string& out) {
+    if (str.empty()) {
+        return;
+    }
+
+    const char* pos = str.data();
+    const char* const end = pos + str.size();
+    const void* backslash = std::memchr(pos, '\\', str.size());
+    if (backslash == nullptr) {
+        out.append(str);
+        return;
+    }
+
+    out.reserve(out.size() + str.size());
+    while (backslash != nullptr) {
+        const char* escape = static_cast<const char*>(backslash);
+        out.append(pos, escape);
+        if (escape + 1 == end) {
+            // A trailing backslash escapes nothing
+            pos = escape;
+            break;
+        }
+
+        const char next = escape[1];
+        switch (next) {
+        case '\\':
+        case '|':
+        case '=':
+            out += next;
+            break;
+        case 'n':
+            out += '\n';
+            break;
+        case 'r':
+            out += '\r';
+            break;
+        case 't':
+            out += '\t';
+            break;
+        default:
+            out += '\\';
+            out += next;
+            break;
+        }
+        pos = escape + 2;
+        backslash = std::memchr(pos, '\\', static_cast<size_t>(end - pos));
+    }
+    out.append(pos, end);
+}
+
+inline std::string unescape(const std::string_view str) {
+    std::string result;
+    appendUnescaped(str, result);
+    return result;
+}
+
+/**
+ * @brief Size of @p str after escaping the characters of class @p escape_class
+ */
+inline size_t escapedSize(const std::string_view str, const CharClass escape_class) {
+    size_t size = str.size();
+    for (const char c : str) {
+        size += (kCharClasses[static_cast<unsigned char>(c)] & escape_class) != 0;
+    }
+    return size;
+}
+
+/**
+ * @brief Write @p str to @p out, escaping the characters of class @p escape_class
+ *
+ * Newlines, carriage returns and tabs become \n, \r and \t, everything else gets a
+ * backslash prefix. @p out must have room for escapedSize(str, escape_class) characters.
+ *
+ * @return Pointer past the last character written
+ */
+inline char* writeEscaped(const std::string_view str,
+                          const CharClass escape_class,
+                          char* out) {
+    for (const char c : str) {
+        if (!(kCharClasses[static_cast<unsigned char>(c)] & escape_class)) {
+            *out++ = c;
+            continue;
+        }
+        *out++ = '\\';
+        *out++ = c == '\n' ? 'n' : c == '\r' ? 'r' : c == '\t' ? 't' : c;
+    }
+    return out;
+}
+
+/**
+ * @brief Tokenize the CEF extension section starting at @p begin of an indexed line
+ *
+ * Calls @p on_pair(key, value) for every key=value pair, in input order. The value is
+ * trimmed but still escaped. A value runs until whitespace that is followed by
+ * another `key=`; a backslash always consumes the following character, so `\=` and
+ * `\\` never end a key or value. The structural index lets the scan jump from one
+ * '=' to the next instead of examining every character.
+ */
+template <typename Callback>
+void forEachExtension(StructuralIndex& index, const size_t begin, Callback&& on_pair) {
+    const std::string_view text = index.text();
+    const size_t n = text.size();
+
+    // The first key is the run of word characters directly before the first '='
+    size_t key_begin = n;
+    size_t key_end = n;
+    for (size_t pos = begin; key_begin == n;) {
+        key_end = index.next(pos, StructuralIndex::Equals);
+        if (key_end == n) {
+            return;
+        }
+        key_begin = key_end;
+        while (key_begin > pos && isWordChar(text[key_begin - 1])) {
+            --key_begin;
+        }
+        if (key_begin == key_end) {
+            key_begin = n;
+            pos = key_end + 1;
+        }
+    }
+
+    while (key_begin < n) {
+        // The value ends at the whitespace before the next unescaped `key=`, so only
+        // the '=' positions need to be visited
+        const size_t value_begin = key_end + 1;
+        size_t value_end = n;
+        size_t next_key_begin = n;
+        size_t next_key_end = n;
+        for (size_t equals = index.next(value_begin, StructuralIndex::Equals); equals < n;
+             equals = index.next(equals + 1, StructuralIndex::Equals)) {
+            size_t word = equals;
+            while (word > value_begin && isWordChar(text[word - 1])) {
+                --word;
+            }
+            if (word == equals || word == value_begin || !isSpaceChar(text[word - 1])) {
+                continue;
+            }
+
+            size_t space = word - 1;
+            while (space > value_begin && isSpaceChar(text[space - 1])) {
+                --space;
+            }
+
+            // A backslash consumes the character after it: skip the first whitespace if
+            // it follows an odd run of backslashes
+            size_t backslash = space;
+            while (backslash > value_begin && text[backslash - 1] == '\\') {
+                --backslash;
+            }
+            if ((space - backslash) % 2 == 1) {
+                ++space;
+            }
+            if (space < word) {
+                value_end = space;
+                next_key_begin = word;
+                next_key_end = equals;
+                break;
+            }
+        }
+
+        on_pair(text.substr(key_begin, key_end - key_begin),
+                trim(text.substr(value_begin, value_end - value_begin)));
+        key_begin = next_key_begin;
+        key_end = next_key_end;
+    }
+}
+
+/**
+ * @brief Tokenize a standalone CEF extension section
+ */
+template <typename Callback>
+void forEachExtension(const std::string_view extensions, Callback&& on_pair) {
+    StructuralIndex index(extensions);
+    forEachExtension(index, 0, std::forward<Callback>(on_pair));
+}
+
+/**
+ * @brief Call @p on_line for every non-blank line of @p text
+ *
+ * Lines end at "\n" and a trailing "\r" is stripped. @p on_line returns false to stop.
+ */
+template <typename Callback>
+void forEachLine(const std::string_view text, Callback&& on_line) {
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+
+        std::string_view line = text.substr(begin, end - begin);
+        begin = end + 1;
+
+        if (line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+        if (!trim(line).empty() && !on_line(line)) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Split @p text into at most @p count ranges of whole lines
+ *
+ * Ranges are roughly equal in size; each one except the last ends right after a
+ * newline, and none is empty.
+ */
+inline std::vector<std::string_view> partitionLines(const std::string_view text,
+                                                    const size_t count) {
+    std::vector<std::string_view> ranges;
+    const size_t target = text.size() / (count > 0 ? count : 1) + 1;
+
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', std::min(begin + target, text.size()) - 1);
+        end = end == std::string_view::npos ? text.size() : end + 1;
+        ranges.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return ranges;
+}
+
+} // namespace cef_cpp::detail
+
+#endif
@@ -0,0 +1,149 @@
+#include "cef_stream_parser.hpp"
+#include "cef_scanner.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <istream>
+#include <system_error>
+#include <unistd.h>
+
+using namespace cef_cpp;
+
+StreamParser::StreamParser(std::istream& input,
+                           const ParseOptions& options,
+                           const size_t chunk_size)
+    : stream_(&input), options_(options), buffer_(std::max<size_t>(chunk_size, 1)) {
+}
+
+StreamParser::StreamParser(const int fd, const ParseOptions& options, const size_t chunk_size)
+    : fd_(fd), options_(options), buffer_(std::max<size_t>(chunk_size, 1)) {
+}
+
+std::optional<Event> StreamParser::next() {
+    const auto view = nextView();
+    if (!view) {
+        return std::nullopt;
+    }
+    return view->toEvent(options_.lazy_extensions, options_.projection.get());
+}
+
+std::optional<EventView> StreamParser::nextView() {
+    std::string_view line;
+    while (nextLine(line)) {
+        auto view = Parser::tryParseView(line, options_);
+        if (view) {
+            return std::move(*view);
+        }
+        if (view.error().code != ParseErrorCode::Filtered) {
+            throw ParseException("Error parsing line " + std::to_string(line_number_) +
+                                 ": " + view.error().message());
+        }
+    }
+    return std::nullopt;
+}
+
+bool StreamParser::nextLine(std::string_view& line) {
+    if (options_.syslog) {
+        return nextFrame(line);
+    }
+
+    while (true) {
+        const char* data = buffer_.data();
+        const void* newline = std::memchr(data + scan_, '\n', end_ - scan_);
+
+        if (newline == nullptr && !eof_) {
+            scan_ = end_;
+            fill();
+            continue;
+        }
+        if (newline == nullptr && begin_ == end_) {
+            return false;
+        }
+
+        // A complete line, or the unterminated tail of the input
+        const size_t line_end =
+            newline != nullptr ? static_cast<const char*>(newline) - data : end_;
+        line = std::string_view(data + begin_, line_end - begin_);
+        begin_ = scan_ = newline != nullptr ? line_end + 1 : end_;
+        ++line_number_;
+
+        if (line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+        if (!detail::trim(line).empty()) {
+            return true;
+        }
+    }
+}
+
+bool StreamParser::nextFrame(std::string_view& frame) {
+    while (true) {
+        size_t consumed = 0;
+        const auto status = extractSyslogFrame(
+            std::string_view(buffer_.data() + begin_, end_ - begin_), eof_, frame, consumed);
+        if (status == FrameStatus::Invalid) {
+            throw ParseException("Invalid syslog frame after frame " +
+                                 std::to_string(line_number_));
+        }
+
+        begin_ += consumed;
+        scan_ = begin_;
+        if (status == FrameStatus::Incomplete) {
+            if (eof_) {
+                return false;
+            }
+            scan_ = end_;
+            fill();
+            continue;
+        }
+
+        ++line_number_;
+        if (!detail::trim(frame).empty()) {
+            return true;
+        }
+    }
+}
+
+void StreamParser::fill() {
+    // Move the partial line to the front to make room for the next chunk
+    if (begin_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        scan_ -= begin_;
+        begin_ = 0;
+    }
+
+    // The buffer only grows when a single line does not fit
+    if (end_ == buffer_.size()) {
+        if (buffer_.size() >= max_line_length_) {
+            throw ParseException("Line " + std::to_string(line_number_ + 1) +
+                                 " exceeds the maximum length of " +
+                                 std::to_string(max_line_length_) + " bytes");
+        }
+        buffer_.resize(std::min(buffer_.size() * 2, max_line_length_));
+    }
+
+    const size_t count = read(buffer_.data() + end_, buffer_.size() - end_);
+    if (count == 0) {
+        eof_ = true;
+    }
+    end_ += count;
+}
+
+size_t StreamParser::read(char* data, const size_t size) {
+    if (stream_ != nullptr) {
+        stream_->read(data, static_cast<std::streamsize>(size));
+        return static_cast<size_t>(stream_->gcount());
+    }
+
+    while (true) {
+        const ssize_t count = ::read(fd_, data, size);
+        if (count >= 0) {
+            return static_cast<size_t>(count);
+        }
+        if (errno != EINTR) {
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include "cef_string_table.hpp"
+
+#include <mutex>
+#include <stdexcept>
+
+using namespace cef_cpp;
+
+StringTable& StringTable::global() {
+    // Leaked on purpose: events in static storage may outlive any destruction order
+    static StringTable* table = new StringTable(kGlobalMaxBytes);
+    return *table;
+}
+
+const std::string& StringTable::intern(const std::string_view str) {
+    const std::string* interned = tryIntern(str);
+    if (interned == nullptr) {
+        throw std::length_error("StringTable is full");
+    }
+    return *interned;
+}
+
+const std::string* StringTable::tryIntern(const std::string_view str) {
+    if (str.empty()) {
+        return &kEmpty;
+    }
+
+    const size_t hash = Hash()(str);
+    Shard& shard = shards_[(hash >> 7) % kShardCount];
+
+    {
+        const std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.strings.find(str); it != shard.strings.end()) {
+            return &*it;
+        }
+    }
+
+    // The string, its node and its bucket; a reservation that overshoots is taken back
+    const size_t cost = sizeof(std::string) + 4 * sizeof(void*) + str.size();
+    const size_t before = bytes_.fetch_add(cost, std::memory_order_relaxed);
+    if (cost > max_bytes_ || before > max_bytes_ - cost) {
+        bytes_.fetch_sub(cost, std::memory_order_relaxed);
+        const std::shared_lock lock(shard.mutex);
+        const auto it = shard.strings.find(str);
+        return it != shard.strings.end() ? &*it : nullptr;
+    }
+
+    const std::unique_lock lock(shard.mutex);
+    const auto [it, inserted] = shard.strings.emplace(str);
+    if (!inserted) {
+        bytes_.fetch_sub(cost, std::memory_order_relaxed);
+    }
+    return &*it;
+}
+
+size_t StringTable::size() const {
+    size_t count = 0;
+    for (const Shard& shard : shards_) {
+        const std::shared_lock lock(shard.mutex);
+        count += shard.strings.size();
+    }
+    return count;
+}
@@ -0,0 +1,132 @@
+#include "cef_structural_index.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CEF_CPP_HAVE_SSE2 1
+#include <immintrin.h>
+#endif
+
+#if defined(CEF_CPP_HAVE_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define CEF_CPP_HAVE_AVX2 1
+#endif
+
+using namespace cef_cpp::detail;
+
+namespace {
+
+[[maybe_unused]] BlockMasks classifyScalar(const char* data) {
+    BlockMasks masks;
+    for (size_t i = 0; i < 64; ++i) {
+        const char c = data[i];
+        const uint64_t bit = uint64_t{1} << i;
+        if (c == '|') {
+            masks.pipe |= bit;
+        } else if (c == '\\') {
+            masks.backslash |= bit;
+        } else if (c == '=') {
+            masks.equals |= bit;
+        } else if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            masks.space |= bit;
+        }
+    }
+    return masks;
+}
+
+#ifdef CEF_CPP_HAVE_SSE2
+BlockMasks classifySse2(const char* data) {
+    const __m128i pipe = _mm_set1_epi8('|');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i equals = _mm_set1_epi8('=');
+    const __m128i blank = _mm_set1_epi8(' ');
+    const __m128i tab_minus_one = _mm_set1_epi8('\t' - 1);
+    const __m128i cr_plus_one = _mm_set1_epi8('\r' + 1);
+
+    BlockMasks masks;
+    for (size_t i = 0; i < 64; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // \t..\r; bytes >= 0x80 compare as negative and never match
+        const __m128i control =
+            _mm_and_si128(_mm_cmpgt_epi8(v, tab_minus_one), _mm_cmplt_epi8(v, cr_plus_one));
+        const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, blank), control);
+
+        masks.pipe |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, pipe)))) << i;
+        masks.backslash |=
+            uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << i;
+        masks.equals |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, equals)))) << i;
+        masks.space |= uint64_t(uint16_t(_mm_movemask_epi8(space))) << i;
+    }
+    return masks;
+}
+#endif
+
+#ifdef CEF_CPP_HAVE_AVX2
+__attribute__((target("avx2"))) BlockMasks classifyAvx2(const char* data) {
+    const __m256i pipe = _mm256_set1_epi8('|');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i equals = _mm256_set1_epi8('=');
+    const __m256i blank = _mm256_set1_epi8(' ');
+    const __m256i tab_minus_one = _mm256_set1_epi8('\t' - 1);
+    const __m256i cr_plus_one = _mm256_set1_epi8('\r' + 1);
+
+    BlockMasks masks;
+    for (size_t i = 0; i < 64; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i control = _mm256_and_si256(_mm256_cmpgt_epi8(v, tab_minus_one),
+                                                 _mm256_cmpgt_epi8(cr_plus_one, v));
+        const __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, blank), control);
+
+        masks.pipe |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, pipe))))
+            << i;
+        masks.backslash |=
+            uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)))) << i;
+        masks.equals |=
+            uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, equals)))) << i;
+        masks.space |= uint64_t(uint32_t(_mm256_movemask_epi8(space))) << i;
+    }
+    return masks;
+}
+#endif
+
+using Classifier = BlockMasks (*)(const char*);
+
+struct SelectedClassifier {
+    Classifier classify;
+    const char* name;
+};
+
+SelectedClassifier selectClassifier() {
+#ifdef CEF_CPP_HAVE_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {classifyAvx2, "avx2"};
+    }
+#endif
+#ifdef CEF_CPP_HAVE_SSE2
+    return {classifySse2, "sse2"};
+#else
+    return {classifyScalar, "scalar"};
+#endif
+}
+
+const SelectedClassifier& selected() {
+    static const SelectedClassifier classifier = selectClassifier();
+    return classifier;
+}
+
+} // namespace
+
+BlockMasks cef_cpp::detail::classifyBlock(const char* data, const size_t size) {
+    if (size >= 64) {
+        return selected().classify(data);
+    }
+
+    // Pad the tail with NUL bytes, which belong to no class
+    char block[64] = {};
+    std::memcpy(block, data, size);
+    return selected().classify(block);
+}
+
+const char* cef_cpp::detail::classifierName() {
+    return selected().name;
+}
@@ -0,0 +1,100 @@
+#ifndef CEF_CPP_CEF_STRUCTURAL_INDEX_H
+#define CEF_CPP_CEF_STRUCTURAL_INDEX_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace cef_cpp::detail {
+
+/**
+ * @brief Positions of structural characters within one 64-byte block, one bit per byte
+ */
+struct BlockMasks {
+    uint64_t pipe = 0;
+    uint64_t backslash = 0;
+    uint64_t equals = 0;
+    // Any of the \s characters, including newlines
+    uint64_t space = 0;
+};
+
+/**
+ * @brief Classify up to 64 bytes starting at @p data
+ *
+ * Uses AVX2 or SSE2 when the CPU supports them (selected once at runtime) and a
+ * scalar loop otherwise.
+ */
+BlockMasks classifyBlock(const char* data, size_t size);
+
+/**
+ * @brief Name of the block classifier selected for this CPU ("avx2", "sse2" or "scalar")
+ */
+const char* classifierName();
+
+/**
+ * @brief Structural index over a CEF line, built lazily one block at a time
+ *
+ * Lets the header splitter and extension tokenizer jump between delimiters instead of
+ * examining every byte. Lookups are cheapest when positions increase monotonically.
+ */
+class StructuralIndex {
+public:
+    enum Class : uint32_t {
+        Pipe = 1u << 0,
+        Backslash = 1u << 1,
+        Equals = 1u << 2,
+        Space = 1u << 3
+    };
+
+    explicit StructuralIndex(const std::string_view text) : text_(text) {}
+
+    std::string_view text() const { return text_; }
+
+    /**
+     * @brief Position of the first character at or after @p pos in any of @p classes
+     *
+     * @return The position, or text().size() if there is none
+     */
+    size_t next(size_t pos, const uint32_t classes) {
+        while (pos < text_.size()) {
+            const size_t block = pos & ~size_t{63};
+            if (block != block_) {
+                masks_ = classifyBlock(text_.data() + block,
+                                       std::min<size_t>(64, text_.size() - block));
+                block_ = block;
+            }
+
+            uint64_t mask = 0;
+            if (classes & Pipe) {
+                mask |= masks_.pipe;
+            }
+            if (classes & Backslash) {
+                mask |= masks_.backslash;
+            }
+            if (classes & Equals) {
+                mask |= masks_.equals;
+            }
+            if (classes & Space) {
+                mask |= masks_.space;
+            }
+
+            mask >>= pos - block;
+            if (mask != 0) {
+                return pos + std::countr_zero(mask);
+            }
+            pos = block + 64;
+        }
+        return text_.size();
+    }
+
+private:
+    std::string_view text_;
+    size_t block_ = ~size_t{0};
+    BlockMasks masks_;
+};
+
+} // namespace cef_cpp::detail
+
+#endif
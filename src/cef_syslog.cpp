@@ -0,0 +1,229 @@
+#include "cef_syslog.hpp"
+#include "cef_scanner.hpp"
+
+using namespace cef_cpp;
+
+namespace {
+
+constexpr std::string_view kCefPrefix = "CEF:";
+constexpr std::string_view kByteOrderMark = "\xEF\xBB\xBF";
+
+bool isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isMonth(const std::string_view str) {
+    for (const std::string_view month : {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul",
+                                         "Aug", "Sep", "Oct", "Nov", "Dec"}) {
+        if (str == month) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Remove and return the text up to the next space, and the space itself
+std::string_view nextToken(std::string_view& rest) {
+    const size_t end = std::min(rest.find(' '), rest.size());
+    const std::string_view token = rest.substr(0, end);
+    rest.remove_prefix(std::min(end + 1, rest.size()));
+    return token;
+}
+
+std::string_view nilToEmpty(const std::string_view value) {
+    return value == "-" ? std::string_view() : value;
+}
+
+bool parsePriority(std::string_view& rest, int& priority) {
+    size_t i = 1;
+    priority = 0;
+    while (i < rest.size() && i <= 3 && isDigit(rest[i])) {
+        priority = priority * 10 + (rest[i] - '0');
+        ++i;
+    }
+    if (i == 1 || i >= rest.size() || rest[i] != '>' || priority > 191) {
+        return false;
+    }
+    rest.remove_prefix(i + 1);
+    return true;
+}
+
+// Skip "[id param="value" ...]" elements; values may contain escaped '"', '\' and ']'
+bool skipStructuredData(std::string_view& rest) {
+    if (rest.starts_with('-')) {
+        rest.remove_prefix(1);
+        return true;
+    }
+    if (!rest.starts_with('[')) {
+        return false;
+    }
+
+    size_t i = 0;
+    while (i < rest.size() && rest[i] == '[') {
+        bool quoted = false;
+        for (++i; i < rest.size(); ++i) {
+            if (quoted && rest[i] == '\\') {
+                ++i;
+            } else if (rest[i] == '"') {
+                quoted = !quoted;
+            } else if (!quoted && rest[i] == ']') {
+                break;
+            }
+        }
+        if (i >= rest.size()) {
+            return false;
+        }
+        ++i;
+    }
+    rest.remove_prefix(i);
+    return true;
+}
+
+bool splitRfc5424(std::string_view rest, SyslogHeader& header, std::string_view& payload) {
+    header.format = SyslogHeader::Format::Rfc5424;
+    nextToken(rest); // VERSION
+    header.timestamp = nilToEmpty(nextToken(rest));
+    header.hostname = nilToEmpty(nextToken(rest));
+    header.app_name = nilToEmpty(nextToken(rest));
+    header.proc_id = nilToEmpty(nextToken(rest));
+    header.msg_id = nilToEmpty(nextToken(rest));
+
+    const std::string_view structured_data = rest;
+    if (!skipStructuredData(rest)) {
+        return false;
+    }
+    header.structured_data =
+        nilToEmpty(structured_data.substr(0, structured_data.size() - rest.size()));
+
+    if (!rest.starts_with(' ')) {
+        return false;
+    }
+    rest.remove_prefix(1);
+    if (rest.starts_with(kByteOrderMark)) {
+        rest.remove_prefix(kByteOrderMark.size());
+    }
+    payload = rest;
+    return payload.starts_with(kCefPrefix);
+}
+
+bool splitRfc3164(std::string_view rest, SyslogHeader& header, std::string_view& payload) {
+    header.format = SyslogHeader::Format::Rfc3164;
+
+    // "Mmm dd [yyyy ]hh:mm:ss" with a space-padded day, or a single token starting with
+    // a digit such as an RFC 3339 timestamp
+    const std::string_view timestamp = rest;
+    if (rest.size() > 4 && rest[3] == ' ' && isMonth(rest.substr(0, 3))) {
+        rest.remove_prefix(4);
+        if (rest.starts_with(' ')) {
+            rest.remove_prefix(1);
+        }
+        nextToken(rest); // Day
+        if (rest.size() > 4 && rest[4] == ' ' && isDigit(rest[0])) {
+            nextToken(rest); // Year
+        }
+        nextToken(rest);
+    } else if (!rest.empty() && isDigit(rest[0])) {
+        nextToken(rest);
+    }
+    header.timestamp = detail::trim(timestamp.substr(0, timestamp.size() - rest.size()));
+
+    // The payload follows the hostname and an optional "tag[pid]:"
+    const size_t cef = rest.starts_with(kCefPrefix) ? 0 : rest.find(" CEF:");
+    if (cef == std::string_view::npos) {
+        return false;
+    }
+    std::string_view prefix = rest.substr(0, cef);
+    payload = rest.substr(cef == 0 ? 0 : cef + 1);
+
+    // A single token ending in ':' is a tag without hostname
+    if (prefix.find(' ') != std::string_view::npos || !prefix.ends_with(':')) {
+        header.hostname = nextToken(prefix);
+    }
+    std::string_view tag = detail::trim(prefix);
+    if (tag.ends_with(':')) {
+        tag.remove_suffix(1);
+    }
+    header.app_name = tag.substr(0, std::min(tag.find('['), tag.size()));
+    return true;
+}
+
+} // namespace
+
+bool cef_cpp::splitSyslogLine(const std::string_view line,
+                              SyslogHeader& header,
+                              std::string_view& payload) {
+    header = SyslogHeader();
+    if (line.starts_with(kCefPrefix)) {
+        payload = line;
+        return true;
+    }
+
+    std::string_view rest = line;
+    if (rest.starts_with('<') && !parsePriority(rest, header.priority)) {
+        return false;
+    }
+
+    // RFC 5424 puts a version number right after the PRI
+    if (header.priority >= 0 && rest.size() > 1 && isDigit(rest[0]) &&
+        (rest[1] == ' ' || (rest.size() > 2 && isDigit(rest[1]) && rest[2] == ' '))) {
+        return splitRfc5424(rest, header, payload);
+    }
+    return splitRfc3164(rest, header, payload);
+}
+
+FrameStatus cef_cpp::extractSyslogFrame(const std::string_view buffer,
+                                        const bool end_of_input,
+                                        std::string_view& frame,
+                                        size_t& consumed) {
+    size_t begin = 0;
+    while (begin < buffer.size() && (buffer[begin] == '\n' || buffer[begin] == '\r')) {
+        ++begin;
+    }
+    consumed = begin;
+    if (begin == buffer.size()) {
+        return FrameStatus::Incomplete;
+    }
+
+    // Octet counting: "LEN SP MSG" with at most 10 length digits. Counted messages
+    // start with their PRI, which tells them apart from timestamp-first lines.
+    size_t length = 0;
+    size_t pos = begin;
+    while (pos < buffer.size() && pos - begin < 10 && isDigit(buffer[pos])) {
+        length = length * 10 + (buffer[pos] - '0');
+        ++pos;
+    }
+    const bool digits = pos > begin;
+    if (digits && !end_of_input && pos + 1 >= buffer.size() &&
+        (pos == buffer.size() || buffer[pos] == ' ')) {
+        // Too few bytes to tell the framings apart
+        return FrameStatus::Incomplete;
+    }
+    const bool counted =
+        digits && pos + 1 < buffer.size() && buffer[pos] == ' ' && buffer[pos + 1] == '<';
+
+    size_t end = 0;
+    if (counted) {
+        if (buffer.size() - pos - 1 < length) {
+            return end_of_input ? FrameStatus::Invalid : FrameStatus::Incomplete;
+        }
+        begin = pos + 1;
+        end = begin + length;
+        consumed = end;
+    } else {
+        end = buffer.find('\n', begin);
+        if (end == std::string_view::npos) {
+            if (!end_of_input) {
+                return FrameStatus::Incomplete;
+            }
+            end = buffer.size();
+        }
+        consumed = std::min(end + 1, buffer.size());
+    }
+
+    // Some senders count a trailing line break as part of the message
+    frame = buffer.substr(begin, end - begin);
+    while (frame.ends_with('\n') || frame.ends_with('\r')) {
+        frame.remove_suffix(1);
+    }
+    return FrameStatus::Complete;
+}
@@ -0,0 +1,138 @@
+#include "cef_thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+using namespace cef_cpp;
+
+namespace {
+
+// Chunks [next, end) not yet claimed by any participant, one queue per participant
+struct alignas(64) ChunkQueue {
+    std::atomic<size_t> next{0};
+    size_t end = 0;
+};
+
+} // namespace
+
+struct ThreadPool::Job {
+    size_t count = 0;
+    size_t grain_size = 1;
+    const std::function<void(size_t, size_t)>* body = nullptr;
+    std::unique_ptr<ChunkQueue[]> queues;
+    size_t queue_count = 0;
+
+    // Workers still inside runJob
+    std::atomic<size_t> active{0};
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The caller of parallelFor is the remaining participant
+    workers_.reserve(thread_count - 1);
+    for (size_t i = 1; i < thread_count; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stop_.store(true, std::memory_order_release);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(const size_t count,
+                             const size_t grain_size,
+                             const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    const std::lock_guard job_lock(job_mutex_);
+
+    Job job;
+    job.count = count;
+    job.grain_size = std::max<size_t>(grain_size, 1);
+    job.body = &body;
+    job.queue_count = getConcurrency();
+    job.queues = std::make_unique<ChunkQueue[]>(job.queue_count);
+
+    // Deal out contiguous runs of chunks, one run per participant
+    const size_t chunks = (count + job.grain_size - 1) / job.grain_size;
+    for (size_t i = 0; i < job.queue_count; ++i) {
+        job.queues[i].next = chunks * i / job.queue_count;
+        job.queues[i].end = chunks * (i + 1) / job.queue_count;
+    }
+
+    if (!workers_.empty()) {
+        job.active.store(workers_.size(), std::memory_order_relaxed);
+        job_.store(&job, std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_release);
+        generation_.notify_all();
+    }
+
+    runJob(job, 0);
+
+    // The job lives on this stack, so wait until every worker has left it
+    for (size_t active = job.active.load(std::memory_order_acquire); active != 0;
+         active = job.active.load(std::memory_order_acquire)) {
+        job.active.wait(active, std::memory_order_acquire);
+    }
+
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+void ThreadPool::workerLoop(const size_t participant) {
+    uint64_t seen = 0;
+    while (true) {
+        generation_.wait(seen, std::memory_order_acquire);
+        seen = generation_.load(std::memory_order_acquire);
+        if (stop_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        Job* job = job_.load(std::memory_order_relaxed);
+        runJob(*job, participant);
+
+        if (job->active.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            job->active.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runJob(Job& job, const size_t participant) {
+    // Drain the own queue first, then steal from the others in turn
+    for (size_t offset = 0; offset < job.queue_count; ++offset) {
+        ChunkQueue& queue = job.queues[(participant + offset) % job.queue_count];
+        while (true) {
+            const size_t chunk = queue.next.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= queue.end) {
+                break;
+            }
+
+            const size_t begin = chunk * job.grain_size;
+            const size_t end = std::min(begin + job.grain_size, job.count);
+            try {
+                (*job.body)(begin, end);
+            } catch (...) {
+                const std::lock_guard lock(job.error_mutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+            }
+        }
+    }
+}
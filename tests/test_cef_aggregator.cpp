@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "cef_aggregator.hpp"
+#include "cef_parser.hpp"
+
+#include <mutex>
+#include <thread>
+
+using namespace cef_cpp;
+
+namespace {
+
+Timestamp at(const int64_t millis) {
+    return Timestamp(std::chrono::milliseconds(millis));
+}
+
+Event event(const std::string& name, const std::string& extensions = "") {
+    return Parser::parse("CEF:0|Security|IDS|1.0|100|" + name + "|5|" + extensions);
+}
+
+} // namespace
+
+// Test that duplicates within a window are emitted once with their count
+TEST(CEFAggregatorTest, Window)
+{
+    std::vector<Event> emitted;
+    Aggregator aggregator([&](Event&& summary) { emitted.push_back(std::move(summary)); });
+
+    aggregator.add(event("scan", "rt=1 src=10.0.0.1"), at(1000));
+    aggregator.add(event("scan", "rt=2 src=10.0.0.2"), at(1200));
+    aggregator.add(event("scan", "rt=3 cnt=5"), at(1500));
+    aggregator.add(event("login"), at(1600));
+    EXPECT_EQ(aggregator.size(), 2);
+
+    // Windows last one second from their first event
+    EXPECT_EQ(aggregator.flush(at(1999)), 0);
+    EXPECT_EQ(aggregator.flush(at(2000)), 1);
+    ASSERT_EQ(emitted.size(), 1);
+    EXPECT_EQ(emitted[0].getName(), "scan");
+    EXPECT_EQ(emitted[0].getInteger(ExtensionKey::BaseEventCount), 7);
+    EXPECT_EQ(emitted[0].getTimestamp(ExtensionKey::StartTime), at(1000));
+    EXPECT_EQ(emitted[0].getTimestamp(ExtensionKey::EndTime), at(1500));
+    EXPECT_EQ(emitted[0].getSourceAddress(), "10.0.0.1");
+
+    // A late duplicate closes its expired window and opens a new one
+    aggregator.add(event("login"), at(2700));
+    ASSERT_EQ(emitted.size(), 2);
+    EXPECT_EQ(emitted[1].getInteger(ExtensionKey::BaseEventCount), 1);
+    EXPECT_EQ(aggregator.flushAll(), 1);
+    EXPECT_EQ(emitted[2].getTimestamp(ExtensionKey::StartTime), at(2700));
+    EXPECT_EQ(aggregator.size(), 0);
+}
+
+// Test keys with extensions and the bound on open windows
+TEST(CEFAggregatorTest, KeysAndCapacity)
+{
+    std::vector<Event> emitted;
+    AggregatorOptions options;
+    options.key = std::make_shared<const Projection>(
+        std::vector<std::string>{"sourceAddress", "act"},
+        std::initializer_list<Projection::HeaderField>{Projection::HeaderField::Name});
+    Aggregator aggregator([&](Event&& summary) { emitted.push_back(std::move(summary)); },
+                          options);
+
+    aggregator.add(event("scan", "src=10.0.0.1 act="), at(0));
+    aggregator.add(event("scan", "src=10.0.0.1 act= dst=1.1.1.1"), at(0));
+    aggregator.add(event("scan", "src=10.0.0.1"), at(0));
+    aggregator.add(event("scan", "src=10.0.0.2 act="), at(0));
+    EXPECT_EQ(aggregator.size(), 3);
+    aggregator.flushAll();
+    ASSERT_EQ(emitted.size(), 3);
+    size_t merged = 0;
+    for (const Event& summary : emitted) {
+        merged += summary.getInteger(ExtensionKey::BaseEventCount) == 2;
+    }
+    EXPECT_EQ(merged, 1);
+
+    // One window per shard: a second key in a full shard closes the first early
+    emitted.clear();
+    options.max_keys = 1;
+    Aggregator bounded([&](Event&& summary) { emitted.push_back(std::move(summary)); },
+                       options);
+    for (int i = 0; i < 1000; ++i) {
+        bounded.add(event("scan", "src=10.0.0." + std::to_string(i)), at(i));
+    }
+    EXPECT_LE(bounded.size(), 64);
+    EXPECT_EQ(emitted.size() + bounded.flushAll(), 1000);
+}
+
+// Test that concurrent inserts are all counted
+TEST(CEFAggregatorTest, Concurrent)
+{
+    std::mutex mutex;
+    int64_t total = 0;
+    size_t summaries = 0;
+    Aggregator aggregator([&](Event&& summary) {
+        const std::lock_guard lock(mutex);
+        total += *summary.getInteger(ExtensionKey::BaseEventCount);
+        ++summaries;
+    });
+
+    std::vector<Event> events;
+    for (int i = 0; i < 100; ++i) {
+        events.push_back(event("event" + std::to_string(i)));
+    }
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int round = 0; round < 50; ++round) {
+                    for (const Event& e : events) {
+                        aggregator.add(e, at(round));
+                    }
+                }
+            });
+        }
+    }
+
+    EXPECT_EQ(aggregator.flushAll(), 100);
+    EXPECT_EQ(summaries, 100);
+    EXPECT_EQ(total, 4 * 50 * 100);
+}
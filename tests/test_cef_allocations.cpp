@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "cef_event.hpp"
+#include "cef_parser.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Built as its own executable: the operator new replaced below would otherwise count
+// the allocations of every other test. Sanitizers bring their own operator new, so
+// the count is unavailable under them.
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define CEF_CPP_SANITIZED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || \
+    __has_feature(memory_sanitizer)
+#define CEF_CPP_SANITIZED
+#endif
+#endif
+
+using namespace cef_cpp;
+
+namespace {
+
+// Heap allocations made by the current thread
+thread_local size_t allocation_count = 0;
+
+} // namespace
+
+#ifndef CEF_CPP_SANITIZED
+void* operator new(const size_t size) {
+    ++allocation_count;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new[](const size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+// Test that parsing into a recycled event stops allocating once its storage has grown
+TEST(CEFAllocationTest, ParseInto)
+{
+    const std::vector<std::string> lines = {
+        "CEF:0|Security|threatmanager|1.0|100|worm successfully stopped|10|"
+        "src=10.0.0.1 dst=2.1.2.2 spt=1232 msg=Detected a threat. No action needed",
+        "CEF:0|Security|threatmanager|1.0|101|pipe\\|name|3|act=blocked a \\= b "
+        "rt=1700000000000 cs1=a value well past the small string buffer",
+        "CEF:1|Acme|firewall|2.1|200|blocked|0|",
+        "CEF:0|Security|threatmanager|1.0|100|bad severity|x|",
+        "<134>1 2024-11-14T22:13:20Z fw01 cef - - - CEF:0|Acme|firewall|2.1|200|blocked|0|"
+        "src=10.0.0.2",
+    };
+    ParseOptions options;
+    options.syslog = true;
+    Parser parser(options);
+    Event event;
+
+    const auto parseAll = [&] {
+        size_t parsed = 0;
+        for (const std::string& line : lines) {
+            parsed += !parser.parseInto(line, event);
+        }
+        return parsed;
+    };
+
+    // The first pass sizes the buffers and interns the header values
+    EXPECT_EQ(parseAll(), 4);
+    EXPECT_EQ(event.getSyslogHostname(), "fw01");
+    EXPECT_EQ(event.getExtensions().size(), 1);
+
+    // Spare strings move between keys, so they take a few passes to all grow to the
+    // longest value
+    for (int i = 0; i < 4; ++i) {
+        parseAll();
+    }
+    const size_t before = allocation_count;
+    for (int i = 0; i < 3; ++i) {
+        parseAll();
+    }
+#ifndef CEF_CPP_SANITIZED
+    EXPECT_EQ(allocation_count - before, 0);
+#else
+    static_cast<void>(before);
+#endif
+
+    ASSERT_FALSE(parser.parseInto(lines[1], event));
+    EXPECT_EQ(event.toString(), Parser::parse(lines[1]).toString());
+    EXPECT_EQ(event.getTimestamp(ExtensionKey::DeviceReceiptTime),
+              Parser::parse(lines[1]).getTimestamp(ExtensionKey::DeviceReceiptTime));
+    EXPECT_EQ(event.getSyslogPriority(), -1);
+    EXPECT_EQ(parser.parseInto(lines[3], event)->code, ParseErrorCode::InvalidSeverity);
+    EXPECT_EQ(event.getName(), "pipe|name");
+}
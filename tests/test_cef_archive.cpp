@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include "cef_archive.hpp"
+#include "cef_parser.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace cef_cpp;
+
+namespace {
+
+const std::vector<std::string> lines = {
+    "CEF:0|Security|threatmanager|1.0|100|worm stopped|10|src=10.0.0.1 dst=2.1.2.2 spt=1232",
+    "CEF:0|Security|threatmanager|1.0|101|pipe\\|name|3|msg=a\\=b\\nc rt=1700000000000",
+    "CEF:1|Acme|firewall|2.1|200|blocked|0|",
+};
+
+std::vector<Event> parsedEvents() {
+    std::vector<Event> events = Parser::parseMultiple(lines);
+    ParseOptions options;
+    options.syslog = true;
+    events.push_back(Parser::parse("<134>1 2024-11-14T22:13:20Z fw01 cef - - - " + lines[0],
+                                   options));
+    return events;
+}
+
+std::string writeArchive(const std::vector<Event>& events, const size_t block_size) {
+    std::ostringstream output;
+    ArchiveWriter writer(output, block_size);
+    writer.write(events);
+    writer.flush();
+    EXPECT_EQ(writer.getEventCount(), events.size());
+    return output.str();
+}
+
+} // namespace
+
+// Test that events survive a write and read, across several blocks
+TEST(CEFArchiveTest, RoundTrip)
+{
+    const std::vector<Event> events = parsedEvents();
+    const std::string archive = writeArchive(events, 3);
+
+    auto reader = ArchiveReader::fromBuffer(archive);
+    std::vector<Event> read;
+    for (const Event& event : reader) {
+        read.push_back(event);
+    }
+    ASSERT_EQ(read.size(), events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        EXPECT_EQ(read[i].toString(), events[i].toString());
+        EXPECT_EQ(read[i].getExtensions(), events[i].getExtensions());
+        EXPECT_EQ(read[i].getSeverity(), events[i].getSeverity());
+    }
+    EXPECT_EQ(read[1].getName(), "pipe|name");
+    EXPECT_EQ(read[1].getTimestamp(ExtensionKey::DeviceReceiptTime),
+              events[1].getTimestamp(ExtensionKey::DeviceReceiptTime));
+    EXPECT_EQ(read[0].getSeverity(), Event::Severity::Unknown);
+    EXPECT_EQ(read[3].getSyslogPriority(), 134);
+    EXPECT_EQ(read[3].getSyslogTimestamp(), "2024-11-14T22:13:20Z");
+    EXPECT_EQ(read[3].getSyslogHostname(), "fw01");
+    EXPECT_EQ(read[2].getSyslogPriority(), -1);
+
+    // Header strings are interned like parsed ones
+    EXPECT_EQ(&read[0].getDeviceVendor(), &events[0].getDeviceVendor());
+
+    // Repeated header values and keys are stored once per block
+    std::vector<std::string> repeated;
+    size_t text_size = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        for (const std::string& line : lines) {
+            repeated.push_back(line);
+            text_size += line.size() + 1;
+        }
+    }
+    EXPECT_LT(writeArchive(Parser::parseMultiple(repeated), 4096).size(), text_size / 2);
+}
+
+// Test reading events in place from a mapped file
+TEST(CEFArchiveTest, Views)
+{
+    const std::vector<Event> events = parsedEvents();
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("cef_cpp_test_" + std::to_string(::getpid()) + ".cefa");
+    {
+        std::ofstream output(path, std::ios::binary);
+        ArchiveWriter writer(output);
+        writer.write(events);
+    }
+
+    ArchiveReader reader(path.string());
+    auto view = reader.nextView();
+    ASSERT_TRUE(view);
+    EXPECT_EQ(view->getVersion(), 0);
+    EXPECT_EQ(view->getDeviceProduct(), "threatmanager");
+    EXPECT_EQ(view->getDeviceEventClassId(), "100");
+    EXPECT_EQ(view->getExtensionCount(), 3);
+    EXPECT_EQ(view->getExtension("dst"), "2.1.2.2");
+    EXPECT_FALSE(view->getExtension("act"));
+
+    std::vector<std::string> keys;
+    view->forEachExtension([&](const std::string_view key, std::string_view) {
+        keys.emplace_back(key);
+    });
+    EXPECT_EQ(keys, (std::vector<std::string>{"dst", "spt", "src"}));
+
+    view = reader.nextView();
+    ASSERT_TRUE(view);
+    EXPECT_EQ(view->getExtension("msg"), "a=b\nc");
+    EXPECT_EQ(reader.next()->getDeviceVendor(), "Acme");
+    view = reader.nextView();
+    ASSERT_TRUE(view);
+    EXPECT_EQ(view->getSyslogAppName(), "cef");
+    EXPECT_FALSE(reader.nextView());
+    EXPECT_FALSE(reader.next());
+
+    std::filesystem::remove(path);
+}
+
+// Test that malformed archives are rejected with their offset
+TEST(CEFArchiveTest, Corrupt)
+{
+    const std::string archive = writeArchive(parsedEvents(), 4096);
+    const auto offset = [](const std::string& data) -> size_t {
+        try {
+            auto reader = ArchiveReader::fromBuffer(data);
+            while (reader.next()) {
+            }
+        } catch (const ArchiveException& e) {
+            return e.getOffset();
+        }
+        return std::string::npos;
+    };
+
+    EXPECT_EQ(offset(archive), std::string::npos);
+    EXPECT_EQ(offset(archive.substr(0, 8)), std::string::npos);
+    EXPECT_EQ(offset(""), 0);
+    EXPECT_EQ(offset("CEF:0|Security|threatmanager|1.0|100|worm stopped|10|"), 0);
+
+    std::string version = archive;
+    version[4] = 2;
+    EXPECT_EQ(offset(version), 4);
+
+    std::string codec = archive;
+    codec[8] = 1;
+    EXPECT_EQ(offset(codec), 8);
+
+    EXPECT_NE(offset(archive.substr(0, archive.size() - 1)), std::string::npos);
+    EXPECT_THROW(ArchiveReader("/nonexistent/archive.cefa"), std::system_error);
+}
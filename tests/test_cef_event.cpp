@@ -0,0 +1,355 @@
+#include <gtest/gtest.h>
+
+#include "cef_event.hpp"
+#include "cef_parser.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace cef_cpp;
+
+// Test that equal strings are stored once, including when interned concurrently
+TEST(CEFEventTest, StringTable)
+{
+    StringTable table;
+    EXPECT_EQ(&table.intern(""), &StringTable::empty());
+
+    const std::string& vendor = table.intern("Security");
+    EXPECT_EQ(vendor, "Security");
+    EXPECT_EQ(&table.intern(std::string("Security")), &vendor);
+    EXPECT_NE(&table.intern("threatmanager"), &vendor);
+    EXPECT_EQ(table.size(), 2);
+
+    std::vector<std::thread> threads;
+    std::vector<const std::string*> interned(8 * 1000);
+    for (size_t t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < 1000; ++i) {
+                interned[t * 1000 + i] = &table.intern("value" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(table.size(), 1002);
+    for (size_t i = 0; i < interned.size(); ++i) {
+        EXPECT_EQ(interned[i], interned[i % 1000]);
+        EXPECT_EQ(*interned[i], "value" + std::to_string(i % 1000));
+    }
+}
+
+// Test that a bounded table declines new strings once its budget is spent
+TEST(CEFEventTest, StringTableBudget)
+{
+    StringTable table(1024);
+    const std::string* vendor = table.tryIntern("Security");
+    ASSERT_NE(vendor, nullptr);
+
+    size_t added = 1;
+    while (table.tryIntern("value" + std::to_string(added)) != nullptr) {
+        ++added;
+    }
+    EXPECT_EQ(table.size(), added);
+    EXPECT_LE(table.getByteSize(), 1024);
+    EXPECT_EQ(table.tryIntern("Security"), vendor);
+    EXPECT_EQ(table.tryIntern(""), &StringTable::empty());
+    EXPECT_EQ(table.tryIntern(std::string(2000, 'x')), nullptr);
+    EXPECT_THROW(table.intern("new value"), std::length_error);
+
+    // Events keep their own copy of device fields the global table declines
+    Event event;
+    event.device_vendor_.assign(nullptr, "Unlisted");
+    EXPECT_EQ(event.getDeviceVendor(), "Unlisted");
+    const Event copy = event;
+    EXPECT_EQ(copy.getDeviceVendor(), "Unlisted");
+    EXPECT_NE(&copy.getDeviceVendor(), &event.getDeviceVendor());
+    event.setDeviceVendor("Security");
+    EXPECT_EQ(&event.getDeviceVendor(), &StringTable::global().intern("Security"));
+}
+
+// Test that the flat map stays sorted and behaves like a map
+TEST(CEFEventTest, ExtensionMap)
+{
+    ExtensionMap extensions;
+    extensions.insert_or_assign("src", "10.0.0.1");
+    extensions.insert_or_assign("act", "blocked");
+    extensions.insert_or_assign("spt", "1232");
+    extensions.insert_or_assign("dst", "2.1.2.2");
+    extensions.insert_or_assign("src", "10.0.0.2");
+
+    ASSERT_EQ(extensions.size(), 4);
+    std::vector<std::string> keys;
+    for (const auto& [key, value] : extensions) {
+        keys.push_back(key);
+    }
+    EXPECT_EQ(keys, (std::vector<std::string>{"act", "dst", "spt", "src"}));
+
+    EXPECT_EQ(extensions.at("src"), "10.0.0.2");
+    EXPECT_THROW(extensions.at("msg"), std::out_of_range);
+    EXPECT_TRUE(extensions.contains("act"));
+    EXPECT_EQ(extensions.find("dpt"), extensions.end());
+
+    // emplace keeps an existing value
+    EXPECT_FALSE(extensions.emplace("act", "allowed").second);
+    EXPECT_EQ(extensions["act"], "blocked");
+
+    EXPECT_EQ(extensions.erase("dst"), 1);
+    EXPECT_EQ(extensions.erase("dst"), 0);
+    EXPECT_EQ(extensions,
+              (ExtensionMap{{"spt", "1232"}, {"act", "blocked"}, {"src", "10.0.0.2"}}));
+}
+
+// Test that parsed events share their header strings
+TEST(CEFEventTest, InternedHeaders)
+{
+    const auto events = Parser::parseMultiple({
+        "CEF:0|Security|threatmanager|1.0|100|worm successfully stopped|10|src=10.0.0.1",
+        "CEF:0|Security|threatmanager|1.0|100|worm successfully stopped|10|src=10.0.0.2",
+        "CEF:0|Sec\\|urity|threatmanager|1.0|100|worm successfully stopped|10|"
+    });
+
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(&events[0].getDeviceVendor(), &events[1].getDeviceVendor());
+    EXPECT_EQ(&events[0].getDeviceVersion(), &events[1].getDeviceVersion());
+    EXPECT_EQ(&events[0].getDeviceEventClassId(), &events[1].getDeviceEventClassId());
+    EXPECT_EQ(events[2].getDeviceVendor(), "Sec|urity");
+    EXPECT_EQ(&events[0].getDeviceProduct(), &events[2].getDeviceProduct());
+
+    Event event = events[0];
+    event.setDeviceVendor("Other");
+    EXPECT_EQ(event.getDeviceVendor(), "Other");
+    EXPECT_EQ(events[0].getDeviceVendor(), "Security");
+    EXPECT_EQ(events[1].getExtension("src"), "10.0.0.2");
+
+    // Names and syslog hostnames take unbounded values, so each event owns its copy
+    EXPECT_EQ(events[0].getName(), events[1].getName());
+    EXPECT_NE(&events[0].getName(), &events[1].getName());
+    const size_t interned = StringTable::global().size();
+    ParseOptions options;
+    options.syslog = true;
+    for (int i = 0; i < 100; ++i) {
+        const std::string id = std::to_string(i);
+        const Event unique = Parser::parse("<134>Nov 14 22:13:20 host" + id +
+                                           " CEF:0|Security|threatmanager|1.0|100|name " +
+                                           id + "|10|", options);
+        EXPECT_EQ(unique.getName(), "name " + id);
+        EXPECT_EQ(unique.getSyslogHostname(), "host" + id);
+    }
+    EXPECT_EQ(StringTable::global().size(), interned);
+}
+
+// Test that every standard key is found through the compile-time table
+TEST(CEFEventTest, ExtensionKeys)
+{
+    for (size_t i = 0; i < kExtensionKeys.size(); ++i) {
+        EXPECT_EQ(findExtensionKey(kExtensionKeys[i].key), static_cast<ExtensionKey>(i))
+            << kExtensionKeys[i].key;
+    }
+    EXPECT_FALSE(findExtensionKey("").has_value());
+    EXPECT_FALSE(findExtensionKey("custom").has_value());
+    EXPECT_FALSE(findExtensionKey("Src").has_value());
+
+    EXPECT_EQ(getExtensionKeyInfo(ExtensionKey::DestinationPort).key, "dpt");
+    EXPECT_EQ(getExtensionKeyInfo(ExtensionKey::DeviceReceiptTime).type,
+              ExtensionType::Timestamp);
+}
+
+// Test address and timestamp conversion
+TEST(CEFEventTest, TypedValueParsing)
+{
+    const auto v4 = IpAddress::parse("10.0.0.1");
+    ASSERT_TRUE(v4.has_value());
+    EXPECT_EQ(v4->family, IpAddress::Family::V4);
+    EXPECT_EQ(v4->bytes[0], 10);
+    EXPECT_EQ(v4->bytes[3], 1);
+    EXPECT_EQ(v4->toString(), "10.0.0.1");
+
+    const auto v6 = IpAddress::parse("2001:db8::1");
+    ASSERT_TRUE(v6.has_value());
+    EXPECT_EQ(v6->family, IpAddress::Family::V6);
+    EXPECT_EQ(v6->toString(), "2001:db8::1");
+
+    EXPECT_FALSE(IpAddress::parse("").has_value());
+    EXPECT_FALSE(IpAddress::parse("10.0.0.256").has_value());
+    EXPECT_FALSE(IpAddress::parse("host.example.com").has_value());
+
+    using namespace std::chrono;
+    EXPECT_EQ(parseTimestamp("1700000000123"), Timestamp(milliseconds(1700000000123)));
+    EXPECT_EQ(parseTimestamp("Nov 14 2023 22:13:20.123"),
+              Timestamp(milliseconds(1700000000123)));
+    EXPECT_EQ(parseTimestamp("Nov 14 2023 22:13:20 UTC"),
+              Timestamp(milliseconds(1700000000000)));
+    EXPECT_EQ(parseTimestamp("Nov 14 2023 22:13:20.5"),
+              Timestamp(milliseconds(1700000000500)));
+    EXPECT_FALSE(parseTimestamp("Nov 14 22:13:20").has_value());
+    EXPECT_FALSE(parseTimestamp("Feb 30 2023 22:13:20").has_value());
+    EXPECT_FALSE(parseTimestamp("Nov 14 2023 22:13:20 CET").has_value());
+    EXPECT_FALSE(parseTimestamp("12ab").has_value());
+}
+
+// Test that typed values are converted at parse time and follow later updates
+TEST(CEFEventTest, TypedExtensions)
+{
+    const std::string line =
+        "CEF:0|Security|threatmanager|1.0|100|worm successfully stopped|10|"
+        "src=10.0.0.1 dst=2001:db8::2 spt=1232 dpt=99999 cnt=3 cfp1=0.25 "
+        "rt=1700000000123 cs1=custom in=notanumber";
+
+    for (const bool lazy : {false, true}) {
+        Event event = Parser::parse(line, {.lazy_extensions = lazy});
+        if (!lazy) {
+            EXPECT_EQ(event.typed_extensions_.size(), 7);
+        }
+
+        EXPECT_EQ(event.getAddress(ExtensionKey::SourceAddress),
+                  IpAddress::parse("10.0.0.1"));
+        EXPECT_EQ(event.getAddress(ExtensionKey::DestinationAddress)->family,
+                  IpAddress::Family::V6);
+        EXPECT_EQ(event.getSourcePort(), 1232);
+        EXPECT_EQ(event.getInteger(ExtensionKey::DestinationPort), 99999);
+        EXPECT_FALSE(event.getDestinationPort().has_value());
+        EXPECT_EQ(event.getInteger(ExtensionKey::BaseEventCount), 3);
+        EXPECT_EQ(event.getFloat(ExtensionKey::DeviceCustomFloatingPoint1), 0.25);
+        EXPECT_EQ(event.getTimestamp(ExtensionKey::DeviceReceiptTime),
+                  Timestamp(std::chrono::milliseconds(1700000000123)));
+
+        // String keys, unconvertible values, absent keys and mismatched types
+        EXPECT_EQ(event.getExtension(ExtensionKey::DeviceCustomString1), "custom");
+        EXPECT_FALSE(event.getInteger(ExtensionKey::DeviceCustomString1).has_value());
+        EXPECT_FALSE(event.getInteger(ExtensionKey::BytesIn).has_value());
+        EXPECT_EQ(event.getExtension(ExtensionKey::BytesIn), "notanumber");
+        EXPECT_FALSE(event.getInteger(ExtensionKey::BytesOut).has_value());
+        EXPECT_FALSE(event.getInteger(ExtensionKey::SourceAddress).has_value());
+
+        event.setSourcePort(80);
+        event.setExtension("src", "not an address");
+        EXPECT_EQ(event.getSourcePort(), 80);
+        EXPECT_FALSE(event.getAddress(ExtensionKey::SourceAddress).has_value());
+        EXPECT_EQ(event.getExtensions().size(), 9);
+    }
+}
+
+// Test that a lazy event can be read and copied from several threads at once
+TEST(CEFEventTest, LazyConcurrentReads)
+{
+    std::string line = "CEF:0|Security|threatmanager|1.0|100|name|10|spt=1232 src=10.0.0.1";
+    for (int i = 0; i < 50; ++i) {
+        line += " cs" + std::to_string(i) + "=value\\=" + std::to_string(i);
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        const Event event = Parser::parse(line, {.lazy_extensions = true});
+        std::vector<std::thread> threads;
+        std::atomic<int> mismatches{0};
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = t; i < 50; i += 2) {
+                    const std::string key = "cs" + std::to_string(i);
+                    mismatches += event.getExtension(key) != "value=" + std::to_string(i);
+                }
+                mismatches += event.getSourcePort() != 1232;
+                const Event copy = event;
+                mismatches += copy.getExtension("cs49") != "value=49";
+                if (t == 3) {
+                    mismatches += event.getExtensions().size() != 52;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(mismatches, 0);
+        EXPECT_EQ(event.toString(), Parser::parse(line).toString());
+    }
+}
+
+// Test that ports must be whole integers within the port range
+TEST(CEFEventTest, PortRange)
+{
+    const auto port = [](const std::string& value) {
+        return Parser::parse("CEF:0|Security|threatmanager|1.0|100|name|10|spt=" + value)
+            .getSourcePort();
+    };
+    EXPECT_EQ(port("443"), 443);
+    EXPECT_EQ(port("0"), 0);
+    EXPECT_EQ(port("65535"), 65535);
+    EXPECT_FALSE(port("65536").has_value());
+    EXPECT_FALSE(port("-1").has_value());
+    EXPECT_FALSE(port("80abc").has_value());
+    EXPECT_FALSE(port("").has_value());
+
+    Event event;
+    event.setDestinationPort(70000);
+    EXPECT_EQ(event.getInteger(ExtensionKey::DestinationPort), 70000);
+    EXPECT_FALSE(event.getDestinationPort().has_value());
+}
+
+// Test that serialization escapes per the spec and parses back to an equal event
+TEST(CEFEventTest, Serialization)
+{
+    Event event;
+    event.setVersion(1);
+    event.setDeviceVendor("Sec|urity");
+    event.setDeviceProduct("C:\\threat");
+    event.setDeviceVersion("1.0");
+    event.setDeviceEventClassId("100");
+    event.setName("multi\nline");
+    event.setSeverity(Event::Severity::High);
+    event.setMessage("a = b | c\\d\r\n");
+    event.setExtension("cs1", "x dst=1.1.1.1");
+    event.setSourcePort(80);
+
+    const std::string expected =
+        "CEF:1|Sec\\|urity|C:\\\\threat|1.0|100|multi\\nline|2|"
+        "cs1=x dst\\=1.1.1.1 msg=a \\= b | c\\\\d\\r\\n spt=80";
+    EXPECT_EQ(event.toString(), expected);
+    EXPECT_EQ(event.getSerializedSize(), expected.size());
+
+    const Event reparsed = Parser::parse(event.toString());
+    EXPECT_EQ(reparsed.getDeviceVendor(), event.getDeviceVendor());
+    EXPECT_EQ(reparsed.getDeviceProduct(), event.getDeviceProduct());
+    EXPECT_EQ(reparsed.getName(), event.getName());
+    EXPECT_EQ(reparsed.getExtensions(), event.getExtensions());
+
+    // Without extensions there is no trailing pipe
+    Event empty;
+    EXPECT_EQ(empty.toString(), "CEF:0||||||-1");
+    EXPECT_EQ(empty.getSerializedSize(), 13);
+
+    std::vector<char> buffer(expected.size() - 1);
+    EXPECT_EQ(event.writeTo(buffer), 0);
+    buffer.resize(expected.size());
+    ASSERT_EQ(event.writeTo(buffer), expected.size());
+    EXPECT_EQ(std::string_view(buffer.data(), buffer.size()), expected);
+}
+
+// Test that a batch is written as one contiguous output into a reused string
+TEST(CEFEventTest, BatchSerialization)
+{
+    const auto events = Parser::parseMultiple({
+        "CEF:0|Security|threatmanager|1.0|100|worm successfully stopped|10|src=10.0.0.1",
+        "CEF:0|Security|threatmanager|1.0|101|worm \\| stopped|3|act=blocked a\\=b",
+        "CEF:0|Security|threatmanager|1.0|102|no extensions|1|"
+    });
+
+    std::string out = "prefix\n";
+    Event::appendTo(events, out);
+    EXPECT_EQ(out,
+              "prefix\n"
+              "CEF:0|Security|threatmanager|1.0|100|worm successfully stopped|-1|"
+              "src=10.0.0.1\n"
+              "CEF:0|Security|threatmanager|1.0|101|worm \\| stopped|3|act=blocked a\\=b\n"
+              "CEF:0|Security|threatmanager|1.0|102|no extensions|1\n");
+
+    // Once the capacity suffices, the output buffer is reused as is
+    const char* data = out.data();
+    for (int i = 0; i < 3; ++i) {
+        out.clear();
+        Event::appendTo(events, out);
+        EXPECT_EQ(out.data(), data);
+    }
+    EXPECT_EQ(Parser::parseFromString(out).size(), 3);
+}
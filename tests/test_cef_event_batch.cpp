@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "cef_event_batch.hpp"
+
+using namespace cef_cpp;
+
+namespace {
+
+// Upstream resource counting the blocks the arena requests
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+
+private:
+    void* do_allocate(const size_t bytes, const size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, const size_t bytes, const size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+// Test that events outlive the source lines and share a few arena blocks
+TEST(CEFEventBatchTest, ArenaStorage)
+{
+    CountingResource upstream;
+    EventBatch batch(4096, &upstream);
+
+    for (int i = 0; i < 1000; ++i) {
+        const std::string line = "CEF:0|Vendor|Product|1.0|100|Event|1|src=10.0.0." +
+                                 std::to_string(i % 256) + " spt=" + std::to_string(i) +
+                                 " msg=escaped \\= value";
+        batch.add(line);
+    }
+
+    ASSERT_EQ(batch.size(), 1000);
+    EXPECT_EQ(batch[0].getDeviceVendor(), "Vendor");
+    EXPECT_EQ(batch[999].getExtension("spt"), "999");
+    EXPECT_EQ(batch[999].getExtension("msg"), "escaped = value");
+    EXPECT_EQ(batch[257].getRawExtensions().get_allocator().resource(), batch.getResource());
+
+    // Geometric block growth keeps the upstream allocations logarithmic
+    EXPECT_LT(upstream.allocations, 20);
+
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+    batch.add("CEF:0|Vendor|Product|1.0|100|Event|1|src=1.1.1.1");
+    EXPECT_EQ(batch[0].getExtension("src"), "1.1.1.1");
+}
+
+// Test batch parsing through the Parser API
+TEST(CEFEventBatchTest, ParseBatch)
+{
+    const std::vector<std::string> lines = {
+        "CEF:0|Vendor1|Product1|1.0|100|Event1|1|src=1.1.1.1",
+        "garbage",
+        "CEF:0|Vendor2|Product2|2.0|200|Event2|2|dst=2.2.2.2"
+    };
+
+    EXPECT_THROW(Parser::parseBatch(lines), ParseException);
+
+    std::vector<LineError> errors;
+    const auto batch = Parser::parseBatch(lines, errors);
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_EQ(batch[1].getDeviceProduct(), "Product2");
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0].line_number, 2);
+
+    const auto event = batch[0].toEvent();
+    EXPECT_EQ(event.getSourceAddress(), "1.1.1.1");
+}
+
+// Test that batches honor the syslog and filter options and skip filtered lines
+TEST(CEFEventBatchTest, ParseBatchOptions)
+{
+    const std::vector<std::string> lines = {
+        "<134>Nov 14 22:13:20 fw01 CEF:0|Vendor1|Product1|1.0|100|Event1|3|src=1.1.1.1",
+        "CEF:0|Vendor2|Product2|2.0|200|Event2|1|dst=2.2.2.2",
+        "CEF:0|Vendor3|Product3|3.0|300|Event3|5|"
+    };
+    ParseOptions options;
+    options.syslog = true;
+    options.filter = std::make_shared<Filter>("deviceVendor != Vendor2");
+
+    const auto batch = Parser::parseBatch(lines, options);
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_EQ(batch[0].getSyslogHeader().hostname, "fw01");
+    EXPECT_EQ(batch[1].getDeviceVendor(), "Vendor3");
+
+    std::vector<LineError> errors;
+    EXPECT_EQ(Parser::parseBatch(lines, errors, options).size(), 2);
+    EXPECT_TRUE(errors.empty());
+
+    EventBatch added;
+    EXPECT_EQ(added.tryAdd(lines[1], options).error().code, ParseErrorCode::Filtered);
+    EXPECT_THROW(added.add(lines[1], options), ParseException);
+    EXPECT_EQ(added.add(lines[0], options).getSyslogHeader().priority, 134);
+    EXPECT_EQ(added.size(), 1);
+}
+
+// Test that a batch move-assigned over another keeps its events and arena
+TEST(CEFEventBatchTest, MoveAssignment)
+{
+    EventBatch target;
+    target.add("CEF:0|Vendor1|Product1|1.0|100|Event1|1|src=1.1.1.1");
+    target.add("CEF:0|Vendor1|Product1|1.0|101|Event2|1|src=1.1.1.2");
+
+    EventBatch source;
+    source.add("CEF:0|Vendor2|Product2|2.0|200|Event3|2|dst=2.2.2.2 msg=a\\=b");
+
+    target = std::move(source);
+    ASSERT_EQ(target.size(), 1);
+    EXPECT_EQ(target[0].getDeviceVendor(), "Vendor2");
+    EXPECT_EQ(target[0].getExtension("msg"), "a=b");
+
+    target.add("CEF:0|Vendor3|Product3|3.0|300|Event4|3|dpt=443");
+    ASSERT_EQ(target.size(), 2);
+    EXPECT_EQ(target[1].toEvent().getDestinationPort(), 443);
+    EXPECT_EQ(target[0].getExtension("dst"), "2.2.2.2");
+}
+
+// Test that a moved-from batch can be cleared and reused
+TEST(CEFEventBatchTest, ReuseAfterMove)
+{
+    EventBatch source;
+    source.add("CEF:0|Vendor1|Product1|1.0|100|Event1|1|src=1.1.1.1");
+
+    EventBatch target(std::move(source));
+    source.clear();
+    EXPECT_TRUE(source.empty());
+    source.add("CEF:0|Vendor2|Product2|2.0|200|Event2|2|dst=2.2.2.2");
+    ASSERT_EQ(source.size(), 1);
+    EXPECT_EQ(source[0].getExtension("dst"), "2.2.2.2");
+    EXPECT_NE(source.getResource(), target.getResource());
+
+    // Adding straight away works as well, and leaves the new owner untouched
+    EventBatch other(std::move(target));
+    target.reserve(4);
+    target.add("CEF:0|Vendor3|Product3|3.0|300|Event3|3|dpt=443");
+    EXPECT_EQ(target.size(), 1);
+    ASSERT_EQ(other.size(), 1);
+    EXPECT_EQ(other[0].getExtension("src"), "1.1.1.1");
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include "cef_event_columns.hpp"
+
+#include <cstring>
+
+using namespace cef_cpp;
+
+namespace {
+
+const std::vector<std::string> lines = {
+    "CEF:0|Security|threatmanager|1.0|100|worm stopped|3|src=10.0.0.1 spt=1232",
+    "CEF:1|Security|threat\\|manager|1.0|101|worm started|7|msg=a\\=b\\nc spt=80",
+    "CEF:0|Acme|firewall|2.1|200|blocked|0|spt=22 spt=2222 dst=10.0.0.2",
+};
+
+std::string_view stringAt(const ArrowArray* array, const size_t row) {
+    const auto* offsets = static_cast<const int32_t*>(array->buffers[1]);
+    const auto* data = static_cast<const char*>(array->buffers[2]);
+    return std::string_view(data + offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+bool validAt(const ArrowArray* array, const size_t row) {
+    const auto* bitmap = static_cast<const uint8_t*>(array->buffers[0]);
+    return bitmap == nullptr || (bitmap[row / 8] >> (row % 8) & 1);
+}
+
+} // namespace
+
+// Test parsing lines into header and extension columns
+TEST(CEFEventColumnsTest, Columns)
+{
+    EventColumns columns({"spt", "msg", "spt", "cs1"});
+    for (const auto& line : lines) {
+        ASSERT_TRUE(columns.tryAppend(line));
+    }
+    ASSERT_EQ(columns.size(), 3);
+    const std::vector<std::string> keys = {"spt", "msg", "cs1"};
+    EXPECT_EQ(columns.getExtensionKeys(), keys);
+
+    EXPECT_EQ(columns.getVersion()[1], 1);
+    EXPECT_EQ(columns.getDeviceProduct()[1], "threat|manager");
+    EXPECT_EQ(columns.getName()[2], "blocked");
+
+    // Repeated values share a dictionary entry
+    const DictionaryColumn& vendor = columns.getDeviceVendor();
+    EXPECT_EQ(vendor.getDictionary().size(), 2);
+    EXPECT_EQ(vendor.getIndices()[0], vendor.getIndices()[1]);
+    EXPECT_EQ(vendor[2], "Acme");
+
+    EXPECT_EQ(columns.getSeverity()[0], static_cast<int8_t>(Event::Severity::VeryHigh));
+    EXPECT_EQ(columns.getSeverity()[1], -1);
+    EXPECT_EQ(columns.getSeverity()[2], static_cast<int8_t>(Event::Severity::Low));
+
+    // Sparse keys are null where absent; the last duplicate wins
+    const StringColumn* port = columns.getExtension("spt");
+    ASSERT_NE(port, nullptr);
+    EXPECT_EQ((*port)[0], "1232");
+    EXPECT_EQ((*port)[2], "2222");
+    EXPECT_EQ(port->getNullCount(), 0);
+
+    const StringColumn* message = columns.getExtension("msg");
+    ASSERT_NE(message, nullptr);
+    EXPECT_FALSE(message->isValid(0));
+    EXPECT_TRUE(message->isValid(1));
+    EXPECT_EQ((*message)[1], "a=b\nc");
+    EXPECT_EQ(message->getNullCount(), 2);
+    EXPECT_EQ(columns.getExtension("cs1")->getNullCount(), 3);
+    EXPECT_EQ(columns.getExtension("dst"), nullptr);
+
+    // A rejected line leaves the columns untouched
+    const auto result = columns.tryAppend("CEF:0|too|few");
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().code, ParseErrorCode::TooFewFields);
+    EXPECT_EQ(columns.size(), 3);
+    EXPECT_EQ(port->size(), 3);
+
+    // Parsed events and syslog lines give the same rows
+    EventColumns from_events({"spt", "msg"});
+    for (const auto& line : lines) {
+        from_events.append(Parser::parse(line));
+    }
+    ASSERT_TRUE(from_events.tryAppend("<134>Nov 14 22:13:20 host " + lines[0],
+                                      ParseOptions{.syslog = true}));
+    EXPECT_EQ(from_events.getDeviceProduct()[1], "threat|manager");
+    EXPECT_EQ((*from_events.getExtension("msg"))[1], "a=b\nc");
+    EXPECT_EQ((*from_events.getExtension("spt"))[2], "2222");
+    EXPECT_EQ((*from_events.getExtension("spt"))[3], "1232");
+    EXPECT_FALSE(from_events.getExtension("msg")->isValid(3));
+
+    from_events.clear();
+    EXPECT_TRUE(from_events.empty());
+    EXPECT_EQ(from_events.getExtension("spt")->size(), 0);
+}
+
+// Test the Arrow C Data Interface export
+TEST(CEFEventColumnsTest, ArrowExport)
+{
+    EventColumns columns({"spt", "msg"});
+    for (const auto& line : lines) {
+        ASSERT_TRUE(columns.tryAppend(line));
+    }
+
+    ArrowSchema schema;
+    ArrowArray array;
+    columns.exportToArrow(&schema, &array);
+
+    // The builder is reset and can be reused
+    EXPECT_TRUE(columns.empty());
+    EXPECT_EQ(columns.getExtension("msg")->size(), 0);
+    ASSERT_TRUE(columns.tryAppend(lines[0]));
+
+    EXPECT_STREQ(schema.format, "+s");
+    ASSERT_EQ(schema.n_children, 9);
+    ASSERT_EQ(array.n_children, 9);
+    EXPECT_EQ(array.length, 3);
+    EXPECT_EQ(array.n_buffers, 1);
+
+    const std::vector<std::string> names = {
+        "version", "device_vendor", "device_product", "device_version",
+        "device_event_class_id", "name", "severity", "spt", "msg"};
+    for (size_t i = 0; i < names.size(); ++i) {
+        EXPECT_EQ(schema.children[i]->name, names[i]);
+        EXPECT_EQ(array.children[i]->length, 3);
+    }
+
+    const ArrowArray* version = array.children[0];
+    EXPECT_STREQ(schema.children[0]->format, "i");
+    EXPECT_EQ(static_cast<const int32_t*>(version->buffers[1])[1], 1);
+
+    // Dictionary-encoded header field
+    const ArrowSchema* product_schema = schema.children[2];
+    const ArrowArray* product = array.children[2];
+    EXPECT_STREQ(product_schema->format, "i");
+    ASSERT_NE(product_schema->dictionary, nullptr);
+    EXPECT_STREQ(product_schema->dictionary->format, "u");
+    ASSERT_NE(product->dictionary, nullptr);
+    EXPECT_EQ(product->dictionary->length, 3);
+    const auto* indices = static_cast<const int32_t*>(product->buffers[1]);
+    EXPECT_EQ(stringAt(product->dictionary, indices[1]), "threat|manager");
+
+    const ArrowArray* severity = array.children[6];
+    EXPECT_STREQ(schema.children[6]->format, "c");
+    EXPECT_EQ(schema.children[6]->flags, ARROW_FLAG_NULLABLE);
+    EXPECT_EQ(severity->null_count, 1);
+    EXPECT_TRUE(validAt(severity, 0));
+    EXPECT_FALSE(validAt(severity, 1));
+    EXPECT_EQ(static_cast<const int8_t*>(severity->buffers[1])[2], 0);
+
+    // Extensions without nulls omit the validity bitmap
+    const ArrowArray* port = array.children[7];
+    EXPECT_EQ(port->null_count, 0);
+    EXPECT_EQ(port->buffers[0], nullptr);
+    EXPECT_EQ(stringAt(port, 2), "2222");
+
+    const ArrowArray* message = array.children[8];
+    EXPECT_STREQ(schema.children[8]->format, "u");
+    EXPECT_EQ(message->null_count, 2);
+    EXPECT_FALSE(validAt(message, 0));
+    EXPECT_EQ(stringAt(message, 1), "a=b\nc");
+
+    // A child moved out by the consumer outlives its parent
+    ArrowArray moved = *array.children[8];
+    array.children[8]->release = nullptr;
+    array.release(&array);
+    EXPECT_EQ(array.release, nullptr);
+    EXPECT_EQ(stringAt(&moved, 1), "a=b\nc");
+    moved.release(&moved);
+
+    schema.release(&schema);
+    EXPECT_EQ(schema.release, nullptr);
+}
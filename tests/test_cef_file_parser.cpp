@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include "cef_parser.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <unistd.h>
+
+using namespace cef_cpp;
+
+namespace {
+
+class TempFile {
+public:
+    explicit TempFile(const std::string& content)
+        : path_(std::filesystem::temp_directory_path() /
+                ("cef_cpp_test_" + std::to_string(::getpid()) + ".log")) {
+        std::ofstream(path_, std::ios::binary) << content;
+    }
+
+    ~TempFile() { std::filesystem::remove(path_); }
+
+    std::string path() const { return path_.string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+} // namespace
+
+// Test that every line is parsed exactly once across the worker ranges
+TEST(CEFFileParserTest, ParallelRanges)
+{
+    // Large enough to be split over several threads
+    constexpr int line_count = 40000;
+    std::string content;
+    for (int i = 0; i < line_count; ++i) {
+        content += "CEF:0|Vendor|Product|1.0|100|Event|1|cnt=" + std::to_string(i) +
+                   " msg=some padding to make the file span a few megabytes\r\n";
+        if (i % 1000 == 0) {
+            content += "\n";
+        }
+    }
+    const TempFile file(content);
+
+    std::mutex mutex;
+    std::set<std::string> seen;
+    const size_t count = Parser::parseFile(file.path(), [&](Event&& event) {
+        const std::lock_guard lock(mutex);
+        seen.insert(event.getExtension("cnt").value());
+    }, 4);
+
+    EXPECT_EQ(count, line_count);
+    EXPECT_EQ(seen.size(), line_count);
+}
+
+// Test error reporting and empty files
+TEST(CEFFileParserTest, Errors)
+{
+    {
+        const TempFile file("CEF:0|Vendor|Product|1.0|100|Event|1\n\nnot cef\n");
+        try {
+            Parser::parseFile(file.path(), [](Event&&) {});
+            FAIL() << "Expected ParseException";
+        } catch (const ParseException& e) {
+            EXPECT_EQ(std::string(e.what()).find("Error parsing line 3"), 0);
+        }
+    }
+
+    {
+        const TempFile file("");
+        EXPECT_EQ(Parser::parseFile(file.path(), [](Event&&) {}), 0);
+    }
+
+    EXPECT_THROW(Parser::parseFile("/nonexistent/cef.log", [](Event&&) {}),
+                 std::system_error);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "cef_filter.hpp"
+#include "cef_parser.hpp"
+#include "cef_stream_parser.hpp"
+#include "cef_thread_pool.hpp"
+
+#include <sstream>
+
+using namespace cef_cpp;
+
+namespace {
+
+const std::string allowed = "CEF:0|Security|threatmanager|1.0|100|worm stopped|1|"
+                            "src=10.1.2.3 act=allowed dpt=443";
+const std::string blocked =
+    "CEF:0|Acme|firewall|2.1|200|blocked|3|src=192.168.7.9 act=blocked dpt=22 "
+    "msg=a\\=b cs1=x cs1=y";
+const std::string ipv6 = "CEF:1|Acme|firewall|2.1|201|v6 blocked|7|src=2001:db8::1";
+
+// Evaluate on both a view and a full event and require them to agree
+bool matches(const std::string& expression, const std::string& line) {
+    const Filter filter(expression);
+    const bool on_view = filter.matches(Parser::parseView(line));
+    EXPECT_EQ(filter.matches(Parser::parse(line)), on_view) << expression;
+    return on_view;
+}
+
+} // namespace
+
+// Test comparisons, sets, prefixes and boolean combinators
+TEST(CEFFilterTest, Expressions)
+{
+    // Numeric comparison against the severity level and extension values
+    EXPECT_TRUE(matches("severity < 2", allowed));
+    EXPECT_FALSE(matches("severity < 2", blocked));
+    EXPECT_TRUE(matches("dpt >= 100", allowed));
+    EXPECT_TRUE(matches("dpt = 443.0", allowed));
+    EXPECT_TRUE(matches("version == 1", ipv6));
+
+    // An unknown severity and absent extensions only satisfy !=
+    EXPECT_FALSE(matches("severity >= 0", ipv6));
+    EXPECT_TRUE(matches("severity != 2", ipv6));
+    EXPECT_FALSE(matches("act = allowed", ipv6));
+    EXPECT_TRUE(matches("act != allowed", ipv6));
+
+    // String comparison, unescaped values, full names and the last duplicate
+    EXPECT_TRUE(matches("act=allowed", allowed));
+    EXPECT_TRUE(matches("deviceVendor = \"Security\"", allowed));
+    EXPECT_TRUE(matches("name = \"worm stopped\"", allowed));
+    EXPECT_TRUE(matches("msg = \"a=b\"", blocked));
+    EXPECT_TRUE(matches("deviceAction = blocked", blocked));
+    EXPECT_TRUE(matches("cs1 = y", blocked));
+    EXPECT_TRUE(matches("deviceProduct > firewall", allowed));
+
+    // Sets with plain values and CIDR blocks
+    EXPECT_TRUE(matches("act in (blocked, denied)", blocked));
+    EXPECT_FALSE(matches("act in (blocked, denied)", allowed));
+    EXPECT_TRUE(matches("act not in (blocked, denied)", allowed));
+    EXPECT_TRUE(matches("src in 10.0.0.0/8", allowed));
+    EXPECT_FALSE(matches("src in 10.0.0.0/8", blocked));
+    EXPECT_TRUE(matches("src in (10.0.0.0/8, 192.168.0.0/20)", blocked));
+    EXPECT_FALSE(matches("src in 192.168.8.0/21", blocked));
+    EXPECT_TRUE(matches("sourceAddress in 2001:db8::/32", ipv6));
+    EXPECT_FALSE(matches("src in 2001:db8::/32", allowed));
+    EXPECT_TRUE(matches("src startswith 192.168.", blocked));
+
+    // Combinators, precedence and keywords in any case
+    EXPECT_TRUE(matches("exists(msg) && !(dpt in (80, 443))", blocked));
+    EXPECT_FALSE(matches("exists(msg)", allowed));
+    EXPECT_TRUE(matches("severity < 2 or act = blocked and dpt = 22", blocked));
+    EXPECT_FALSE(matches("(severity < 2 or act = blocked) and dpt = 443", blocked));
+    EXPECT_TRUE(matches("NOT deviceVendor = Acme AND severity<2", allowed));
+
+    const Filter filter("sourceAddress in 10.0.0.0/8 or act = x or src = y");
+    EXPECT_EQ(filter.getExtensionKeys(), (std::vector<std::string>{"src", "act"}));
+}
+
+// Test that malformed expressions are rejected with their offset
+TEST(CEFFilterTest, SyntaxErrors)
+{
+    const auto offset = [](const std::string& expression) -> size_t {
+        try {
+            Filter filter(expression);
+        } catch (const FilterException& e) {
+            return e.getOffset();
+        }
+        return std::string::npos;
+    };
+
+    EXPECT_EQ(offset(""), 0);
+    EXPECT_EQ(offset("severity"), 8);
+    EXPECT_EQ(offset("severity <"), 10);
+    EXPECT_EQ(offset("act = \"open"), 6);
+    EXPECT_EQ(offset("(act = x"), 8);
+    EXPECT_EQ(offset("act in (a, b"), 12);
+    EXPECT_EQ(offset("act = x y"), 8);
+    EXPECT_EQ(offset("act = x & y"), 8);
+    EXPECT_EQ(offset("= x"), 0);
+    EXPECT_THROW(Filter("act in"), FilterException);
+}
+
+// Test filtering while parsing, including rejection on the header alone
+TEST(CEFFilterTest, ParseWithFilter)
+{
+    ParseOptions options;
+    options.filter = std::make_shared<Filter>("severity >= 2 and act != allowed");
+
+    const auto rejected = Parser::tryParse(allowed, options);
+    ASSERT_FALSE(rejected);
+    EXPECT_EQ(rejected.error().code, ParseErrorCode::Filtered);
+    ASSERT_TRUE(Parser::tryParse(blocked, options));
+    EXPECT_THROW(Parser::parse(allowed, options), ParseException);
+
+    // The header decides the first line before its extensions are scanned
+    EventView view = Parser::parseView(allowed);
+    view.extensions_.clear();
+    EXPECT_EQ(options.filter->evaluate(view, false), Filter::Match::False);
+    EXPECT_EQ(Filter("act = x").evaluate(view, false), Filter::Match::Unknown);
+    const Filter either("act = x or severity = 1");
+    EXPECT_EQ(either.evaluate(view, false), Filter::Match::True);
+
+    // Bulk parsing skips filtered lines without reporting them
+    const std::vector<std::string> lines = {allowed, blocked, "junk", allowed,
+                                            blocked};
+    std::vector<LineError> errors;
+    auto events = Parser::parseMultiple(lines, errors, options);
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[1].getDeviceVendor(), "Acme");
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0].line_number, 3);
+
+    ThreadPool pool(2);
+    errors.clear();
+    events = Parser::parseMultiple(lines, errors, pool, options);
+    EXPECT_EQ(events.size(), 2);
+    EXPECT_EQ(errors.size(), 1);
+
+    std::istringstream input(allowed + "\n" + blocked + "\n" + allowed + "\n");
+    StreamParser stream(input, options);
+    std::vector<Event> streamed;
+    for (const auto& event : stream) {
+        streamed.push_back(event);
+    }
+    ASSERT_EQ(streamed.size(), 1);
+    EXPECT_EQ(streamed[0].getDeviceEventClassId(), "200");
+
+    options.syslog = true;
+    EXPECT_TRUE(Parser::tryParse("<134>Nov 14 22:13:20 host " + blocked, options));
+    EXPECT_FALSE(Parser::tryParse("<134>Nov 14 22:13:20 host " + allowed, options));
+}
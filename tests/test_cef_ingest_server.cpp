@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include "cef_ingest_server.hpp"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <mutex>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace cef_cpp;
+
+namespace {
+
+const std::string cef_line =
+    "CEF:0|Security|threatmanager|1.0|100|worm successfully stopped|10|src=10.0.0.1 spt=";
+
+sockaddr_in loopback(const uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+void sendDatagram(const uint16_t port, const std::string& message) {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    const sockaddr_in addr = loopback(port);
+    sendto(fd, message.data(), message.size(), 0, reinterpret_cast<const sockaddr*>(&addr),
+           sizeof(addr));
+    close(fd);
+}
+
+void sendStream(const uint16_t port, const std::string& data) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    const sockaddr_in addr = loopback(port);
+    ASSERT_EQ(connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)), 0);
+
+    // Send in small pieces so frames straddle reads
+    for (size_t pos = 0; pos < data.size(); pos += 7) {
+        const std::string_view piece = std::string_view(data).substr(pos, 7);
+        ASSERT_EQ(send(fd, piece.data(), piece.size(), 0), piece.size());
+    }
+    close(fd);
+}
+
+template <typename Predicate>
+bool waitFor(Predicate&& predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+// Test receiving over UDP and TCP on the loopback interface
+TEST(CEFIngestServerTest, Loopback)
+{
+    std::mutex mutex;
+    std::vector<int> ports;
+    std::vector<std::string> hosts;
+    std::vector<std::string> errors;
+
+    IngestOptions options;
+    options.bind_address = "127.0.0.1";
+    options.udp_port = 0;
+    options.tcp_port = 0;
+    options.worker_count = 3;
+
+    IngestServer server(
+        options,
+        [&](Event&& event) {
+            const std::lock_guard lock(mutex);
+            ports.push_back(event.getSourcePort().value_or(-1));
+            hosts.push_back(event.getSyslogHostname());
+        },
+        [&](const std::string_view message, const ParseError&) {
+            const std::lock_guard lock(mutex);
+            errors.emplace_back(message);
+        });
+    ASSERT_NE(server.getUdpPort(), 0);
+    ASSERT_NE(server.getTcpPort(), 0);
+
+    // One message per datagram, and two lines in one datagram
+    for (int i = 0; i < 50; ++i) {
+        sendDatagram(server.getUdpPort(), "<134>Nov 14 22:13:20 udp " + cef_line +
+                                              std::to_string(i) + "\n");
+    }
+    sendDatagram(server.getUdpPort(), cef_line + "50\n" + cef_line + "51");
+
+    // Octet-counted and newline-terminated frames, and one malformed message
+    std::string stream;
+    for (int i = 100; i < 150; ++i) {
+        const std::string frame = "<134>Nov 14 22:13:20 tcp " + cef_line + std::to_string(i);
+        stream += i % 2 == 0 ? std::to_string(frame.size()) + " " + frame : frame + "\n";
+    }
+    stream += "not cef\n";
+    stream += cef_line + "150";
+    sendStream(server.getTcpPort(), stream);
+
+    ASSERT_TRUE(waitFor([&] {
+        const auto stats = server.getStats();
+        return stats.parsed + stats.parse_errors == 104;
+    })) << server.getStats().received;
+    server.stop();
+
+    const auto stats = server.getStats();
+    EXPECT_EQ(stats.received, 104);
+    EXPECT_EQ(stats.parsed, 103);
+    EXPECT_EQ(stats.parse_errors, 1);
+    EXPECT_EQ(stats.dropped, 0);
+    EXPECT_EQ(stats.connections_accepted, 1);
+    EXPECT_EQ(stats.connections_rejected, 0);
+
+    std::sort(ports.begin(), ports.end());
+    for (int i = 0; i < 52; ++i) {
+        EXPECT_EQ(ports[i], i);
+    }
+    for (int i = 0; i < 51; ++i) {
+        EXPECT_EQ(ports[52 + i], 100 + i);
+    }
+    EXPECT_EQ(std::count(hosts.begin(), hosts.end(), "udp"), 50);
+    EXPECT_EQ(std::count(hosts.begin(), hosts.end(), "tcp"), 50);
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0], "not cef");
+}
+
+// Test that a full queue drops messages and counts them
+TEST(CEFIngestServerTest, DropWhenFull)
+{
+    std::atomic<bool> release{false};
+    std::atomic<int> events{0};
+
+    IngestOptions options;
+    options.bind_address = "127.0.0.1";
+    options.udp_port = 0;
+    options.worker_count = 1;
+    options.queue_capacity = 4;
+
+    IngestServer server(options, [&](Event&&) {
+        release.wait(false);
+        ++events;
+    });
+
+    for (int i = 0; i < 50; ++i) {
+        sendDatagram(server.getUdpPort(), cef_line + std::to_string(i));
+    }
+    ASSERT_TRUE(waitFor([&] { return server.getStats().received == 50; }));
+
+    release = true;
+    release.notify_all();
+    server.stop();
+
+    const auto stats = server.getStats();
+    EXPECT_GT(stats.dropped, 0);
+    EXPECT_EQ(stats.parsed + stats.dropped, 50);
+    EXPECT_EQ(events, stats.parsed);
+}
+
+// Test that datagrams longer than the message size are dropped rather than cut off
+TEST(CEFIngestServerTest, OversizedDatagram)
+{
+    std::atomic<int> events{0};
+
+    IngestOptions options;
+    options.bind_address = "127.0.0.1";
+    options.udp_port = 0;
+    options.worker_count = 1;
+    options.max_message_size = 256;
+
+    IngestServer server(options, [&](Event&&) { ++events; });
+    sendDatagram(server.getUdpPort(), cef_line + "1 msg=" + std::string(300, 'x'));
+    sendDatagram(server.getUdpPort(), cef_line + "2");
+    ASSERT_TRUE(waitFor([&] {
+        const auto stats = server.getStats();
+        return stats.truncated == 1 && stats.parsed == 1;
+    }));
+    server.stop();
+
+    const auto stats = server.getStats();
+    EXPECT_EQ(stats.received, 1);
+    EXPECT_EQ(stats.parse_errors, 0);
+    EXPECT_EQ(events, 1);
+}
+
+// Test that a failure of the network thread is reported by stop()
+TEST(CEFIngestServerTest, NetworkError)
+{
+    IngestOptions options;
+    options.bind_address = "127.0.0.1";
+    options.udp_port = 0;
+    options.worker_count = 1;
+
+    IngestServer server(options, [](Event&&) {});
+    EXPECT_TRUE(server.isReceiving());
+
+    // Swap the epoll descriptor for one epoll_wait rejects, at the latest once the
+    // datagram wakes the network thread
+    const int other = eventfd(0, 0);
+    ASSERT_GE(dup2(other, server.epoll_fd_), 0);
+    close(other);
+    sendDatagram(server.getUdpPort(), cef_line + "1");
+
+    ASSERT_TRUE(waitFor([&] { return !server.isReceiving(); }));
+    EXPECT_THROW(server.stop(), std::system_error);
+    EXPECT_NO_THROW(server.stop());
+}
+
+// Test that blocking backpressure loses nothing and oversized frames are rejected
+TEST(CEFIngestServerTest, Backpressure)
+{
+    std::atomic<int> events{0};
+
+    IngestOptions options;
+    options.bind_address = "127.0.0.1";
+    options.tcp_port = 0;
+    options.worker_count = 1;
+    options.queue_capacity = 2;
+    options.drop_when_full = false;
+    options.max_message_size = 256;
+
+    IngestServer server(options, [&](Event&&) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        ++events;
+    });
+
+    std::string stream;
+    for (int i = 0; i < 200; ++i) {
+        stream += cef_line + std::to_string(i) + "\n";
+    }
+    sendStream(server.getTcpPort(), stream);
+    sendStream(server.getTcpPort(), std::string(1000, 'x'));
+
+    ASSERT_TRUE(waitFor([&] {
+        const auto stats = server.getStats();
+        return events == 200 && stats.connections_rejected == 1;
+    }));
+    server.stop();
+
+    const auto stats = server.getStats();
+    EXPECT_EQ(stats.dropped, 0);
+    EXPECT_GT(stats.backpressure_waits, 0);
+    EXPECT_EQ(stats.connections_accepted, 2);
+
+    EXPECT_THROW(IngestServer(IngestOptions(), [](Event&&) {}), std::invalid_argument);
+}
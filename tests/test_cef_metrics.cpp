@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "cef_metrics.hpp"
+#include "cef_parser.hpp"
+
+#include <thread>
+
+using namespace cef_cpp;
+
+// Test bucketing and the Prometheus text format
+TEST(CEFMetricsTest, PrometheusExport)
+{
+    EXPECT_EQ(Histogram::bucketFor(0, 32), 0);
+    EXPECT_EQ(Histogram::bucketFor(32, 32), 0);
+    EXPECT_EQ(Histogram::bucketFor(33, 32), 1);
+    EXPECT_EQ(Histogram::bucketFor(64, 32), 1);
+    EXPECT_EQ(Histogram::bucketFor(65, 32), 2);
+    EXPECT_EQ(Histogram::bucketFor(uint64_t{1} << 40, 32), Histogram::kBuckets - 1);
+
+    ParserMetrics metrics;
+    metrics.lines = 3;
+    metrics.bytes = 120;
+    metrics.events = 2;
+    metrics.errors[static_cast<size_t>(ParseErrorCode::InvalidSeverity)] = 1;
+    metrics.extensions.buckets[0] = 1;
+    metrics.extensions.buckets[2] = 1;
+    metrics.extensions.count = 2;
+    metrics.extensions.sum = 4;
+    metrics.unescape.buckets[1] = 2;
+    metrics.unescape.count = 2;
+    metrics.unescape.sum = 100;
+
+    const std::string text = metrics.toPrometheus("cef");
+    const auto contains = [&](const std::string& line) {
+        return text.find(line + "\n") != std::string::npos;
+    };
+    EXPECT_TRUE(contains("# TYPE cef_lines_total counter"));
+    EXPECT_TRUE(contains("cef_lines_total 3"));
+    EXPECT_TRUE(contains("cef_bytes_total 120"));
+    EXPECT_TRUE(contains("cef_errors_total{reason=\"invalid_severity\"} 1"));
+    EXPECT_TRUE(contains("cef_errors_total{reason=\"missing_prefix\"} 0"));
+    EXPECT_TRUE(contains("# TYPE cef_extensions histogram"));
+    EXPECT_TRUE(contains("cef_extensions_bucket{le=\"1\"} 1"));
+    EXPECT_TRUE(contains("cef_extensions_bucket{le=\"2\"} 1"));
+    EXPECT_TRUE(contains("cef_extensions_bucket{le=\"4\"} 2"));
+    EXPECT_TRUE(contains("cef_extensions_bucket{le=\"+Inf\"} 2"));
+    EXPECT_TRUE(contains("cef_extensions_sum 4"));
+    EXPECT_TRUE(
+        contains("cef_stage_duration_seconds_bucket{stage=\"unescape\",le=\"3.2e-08\"} 0"));
+    EXPECT_TRUE(
+        contains("cef_stage_duration_seconds_bucket{stage=\"unescape\",le=\"6.4e-08\"} 2"));
+    EXPECT_TRUE(contains("cef_stage_duration_seconds_sum{stage=\"unescape\"} 1e-07"));
+    EXPECT_TRUE(contains("cef_stage_duration_seconds_count{stage=\"header_split\"} 0"));
+}
+
+// Test that the parser records lines, errors and stages across threads
+TEST(CEFMetricsTest, Recording)
+{
+    Metrics::reset();
+    const std::string line = "CEF:0|Security|threatmanager|1.0|100|worm stopped|10|"
+                             "src=10.0.0.1 dst=2.1.2.2 spt=1232";
+
+    EXPECT_TRUE(Parser::tryParse(line));
+    EXPECT_FALSE(Parser::tryParse("CEF:0|Vendor|Product|1.0|100|Name|high|"));
+    std::thread worker([] {
+        EXPECT_FALSE(Parser::tryParse("LEEF:1.0|Vendor|Product|1.0|100|"));
+        EXPECT_FALSE(Parser::tryParse("CEF:0|Vendor|Product"));
+        ParseOptions options;
+        options.syslog = true;
+        EXPECT_FALSE(Parser::tryParse("no syslog header", options));
+    });
+    worker.join();
+
+    const ParserMetrics metrics = Metrics::snapshot();
+    if constexpr (!Metrics::kEnabled) {
+        EXPECT_EQ(metrics.lines, 0);
+        EXPECT_EQ(metrics.header_split.count, 0);
+        GTEST_SKIP() << "Built without CEF_CPP_ENABLE_METRICS";
+    }
+
+    // The worker's counts survive the thread
+    EXPECT_EQ(metrics.lines, 5);
+    EXPECT_EQ(metrics.events, 1);
+    EXPECT_EQ(metrics.bytes, line.size() + 39 + 32 + 20 + 16);
+    EXPECT_EQ(metrics.getErrors(ParseErrorCode::InvalidSeverity), 1);
+    EXPECT_EQ(metrics.getErrors(ParseErrorCode::MissingPrefix), 1);
+    EXPECT_EQ(metrics.getErrors(ParseErrorCode::TooFewFields), 1);
+    EXPECT_EQ(metrics.getErrors(ParseErrorCode::InvalidSyslogHeader), 1);
+
+    EXPECT_EQ(metrics.extensions.count, 1);
+    EXPECT_EQ(metrics.extensions.sum, 3);
+    EXPECT_EQ(metrics.extensions.buckets[2], 1);
+    EXPECT_EQ(metrics.header_split.count, 3);
+    EXPECT_EQ(metrics.extension_tokenize.count, 1);
+    EXPECT_EQ(metrics.unescape.count, 1);
+
+    Metrics::reset();
+    EXPECT_EQ(Metrics::snapshot().lines, 0);
+    EXPECT_TRUE(Parser::tryParseView(line));
+    EXPECT_EQ(Metrics::snapshot().lines, 1);
+}
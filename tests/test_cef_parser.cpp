@@ -68,6 +68,65 @@ TEST(CEFParserTest, ParseExtensions)
     }
 }
 
+// Test key/value boundary detection of the extension tokenizer
+TEST(CEFParserTest, ExtensionBoundaries)
+{
+    {
+        // Escaped separators never end a value
+        const auto extensions = Parser::parseExtensions(R"(msg=a\ b=c cs1=x\\ cs2=y)");
+
+        EXPECT_EQ(extensions.size(), 3);
+        EXPECT_EQ(extensions.at("msg"), "a\\ b=c");
+        EXPECT_EQ(extensions.at("cs1"), "x\\");
+        EXPECT_EQ(extensions.at("cs2"), "y");
+    }
+
+    {
+        // Whitespace is only a separator when followed by a key
+        const auto extensions = Parser::parseExtensions("a=1  two words b.c=2 d=  3  ");
+
+        EXPECT_EQ(extensions.size(), 2);
+        EXPECT_EQ(extensions.at("a"), "1  two words b.c=2");
+        EXPECT_EQ(extensions.at("d"), "3");
+    }
+
+    {
+        // Empty values, leading junk and duplicate keys
+        const auto extensions = Parser::parseExtensions("junk a= b=1 b=2");
+
+        EXPECT_EQ(extensions.size(), 2);
+        EXPECT_EQ(extensions.at("a"), "");
+        EXPECT_EQ(extensions.at("b"), "2");
+    }
+
+    EXPECT_TRUE(Parser::parseExtensions("no pairs here").empty());
+}
+
+// Test delimiters and escapes straddling the 64-byte blocks of the structural index
+TEST(CEFParserTest, LongLines)
+{
+    const std::string vendor = std::string(60, 'v') + "\\|" + std::string(60, 'w');
+    std::string cef_line = "CEF:0|" + vendor + "|Product|1.0|100|Event|1|";
+    std::string expected_msg;
+    for (int i = 0; i < 40; ++i) {
+        cef_line += "cs" + std::to_string(i) + "=value " + std::to_string(i) + " ";
+        expected_msg += "word\\= ";
+    }
+    cef_line += "msg=" + std::string(3, ' ');
+    for (int i = 0; i < 40; ++i) {
+        cef_line += "word\\\\= ";
+    }
+
+    const auto event = Parser::parse(cef_line);
+    EXPECT_EQ(event.getDeviceVendor(), std::string(60, 'v') + "|" + std::string(60, 'w'));
+    EXPECT_EQ(event.getDeviceProduct(), "Product");
+    EXPECT_EQ(event.getExtensions().size(), 41);
+    EXPECT_EQ(event.getExtension("cs0"), "value 0");
+    EXPECT_EQ(event.getExtension("cs39"), "value 39");
+    expected_msg.pop_back();
+    EXPECT_EQ(event.getMessage(), expected_msg);
+}
+
 // Test escaped characters in fields
 TEST(CEFParserTest, EscapedCharacters)
 {
@@ -79,6 +138,105 @@ TEST(CEFParserTest, EscapedCharacters)
     EXPECT_EQ(event.getDeviceProduct(), "Product=1");
     EXPECT_EQ(event.getName(), "Event|Name");
     EXPECT_EQ(event.getMessage(), "Message with = and | chars");
+
+    // Adjacent escapes, escapes at either end, unknown sequences and a lone trailing
+    // backslash, around runs that are copied as a whole
+    const std::string run(100, 'x');
+    const auto escaped = Parser::parse(
+        R"(CEF:0|V|P|1.0|100|N|1|a=\\\=\n b=)" + run + R"(\q\t)" + run + R"( c=\|end\)");
+    EXPECT_EQ(escaped.getExtension("a"), "\\=\n");
+    EXPECT_EQ(escaped.getExtension("b"), run + "\\q\t" + run);
+    EXPECT_EQ(escaped.getExtension("c"), "|end\\");
+    EXPECT_EQ(Parser::parse(escaped.toString()).getExtensions(), escaped.getExtensions());
+}
+
+// Test that only an odd run of backslashes escapes a header pipe
+TEST(CEFParserTest, EscapedBackslashBeforePipe)
+{
+    const auto event = Parser::parse(
+        R"(CEF:0|Vendor\\|Product\\\|X|1.0\\\\|100|Name|1|request=http://a/?q=1|2 cmd=a|b)");
+    EXPECT_EQ(event.getDeviceVendor(), "Vendor\\");
+    EXPECT_EQ(event.getDeviceProduct(), "Product\\|X");
+    EXPECT_EQ(event.getDeviceVersion(), "1.0\\\\");
+    EXPECT_EQ(event.getDeviceEventClassId(), "100");
+    EXPECT_EQ(event.getExtension("request"), "http://a/?q=1|2");
+    EXPECT_EQ(event.getExtension("cmd"), "a|b");
+
+    // A field ending in a backslash serializes as `\\|` and must read back the same
+    Event original;
+    original.setDeviceVendor("C:\\");
+    original.setDeviceProduct("a|b\\");
+    original.setDeviceVersion("1");
+    original.setDeviceEventClassId("1");
+    original.setName("n");
+    original.setSeverity(1);
+    const auto reparsed = Parser::parse(original.toString());
+    EXPECT_EQ(reparsed.getDeviceVendor(), "C:\\");
+    EXPECT_EQ(reparsed.getDeviceProduct(), "a|b\\");
+    EXPECT_EQ(reparsed.getName(), "n");
+
+    // The extension section is a single span however many pipes it contains
+    const auto view = Parser::parseView("CEF:0|V|P|1|1|N|1|cmd=a|b|c|d|e|f|g|h");
+    EXPECT_EQ(view.getRawExtensionPart(), "cmd=a|b|c|d|e|f|g|h");
+}
+
+// Test zero-copy parsing into an EventView
+TEST(CEFParserTest, ParseView)
+{
+    const std::string cef_line =
+        R"(CEF:0|Test\|Vendor|IDS|1.0|100|Event|2|src=1.1.1.1 msg=a \= b spt=80 src=2.2.2.2)";
+    const auto view = Parser::parseView(cef_line);
+
+    EXPECT_EQ(view.getVersion(), 0);
+    EXPECT_EQ(view.getRawDeviceVendor(), R"(Test\|Vendor)");
+    EXPECT_EQ(view.getDeviceVendor(), "Test|Vendor");
+    EXPECT_EQ(view.getDeviceProduct(), "IDS");
+    EXPECT_EQ(view.getSeverity(), Event::Severity::High);
+
+    // Views point into the input buffer
+    EXPECT_EQ(view.getRawName().data(), cef_line.data() + cef_line.find("Event"));
+
+    EXPECT_EQ(view.getRawExtensions().size(), 4);
+    EXPECT_EQ(view.getRawExtension("msg"), R"(a \= b)");
+    EXPECT_EQ(view.getExtension("msg"), "a = b");
+    EXPECT_EQ(view.getExtension("src"), "2.2.2.2");
+    EXPECT_FALSE(view.getExtension("dst").has_value());
+
+    const auto event = view.toEvent();
+    EXPECT_EQ(event.getDeviceVendor(), "Test|Vendor");
+    EXPECT_EQ(event.getSourcePort(), 80);
+    EXPECT_EQ(event.getSourceAddress(), "2.2.2.2");
+    EXPECT_EQ(event.getExtensions().size(), 3);
+
+    EXPECT_THROW(Parser::parseView("CEF:0|Too|Few|Fields"), ParseException);
+}
+
+// Test lazily decoded extensions
+TEST(CEFParserTest, LazyExtensions)
+{
+    const std::string cef_line =
+        R"(CEF:0|Test|Product|1.0|100|Event|1|src=1.1.1.1 spt=80 msg=a \= b src=2.2.2.2)";
+    ParseOptions options;
+    options.lazy_extensions = true;
+    auto event = Parser::parse(cef_line, options);
+
+    EXPECT_EQ(event.extensions_.size(), 0);
+    EXPECT_EQ(event.getSourcePort(), 80);
+    EXPECT_EQ(event.getMessage(), "a = b");
+    EXPECT_EQ(event.getSourceAddress(), "2.2.2.2");
+    EXPECT_FALSE(event.getDestinationAddress().has_value());
+    EXPECT_EQ(event.extensions_.size(), 3);
+
+    // Explicitly set values override the raw ones
+    event.setProtocol("UDP");
+    event.setExtension("spt", "8080");
+    const auto& extensions = event.getExtensions();
+    EXPECT_EQ(extensions.size(), 4);
+    EXPECT_EQ(extensions.at("spt"), "8080");
+    EXPECT_EQ(extensions.at("msg"), "a = b");
+    EXPECT_TRUE(event.lazy_extensions_.empty());
+
+    EXPECT_EQ(Parser::parse(event.toString()).getExtensions(), extensions);
 }
 
 // Test invalid lines throw exceptions
@@ -97,6 +255,61 @@ TEST(CEFParserTest, InvalidFormat)
     }
 }
 
+// Test error codes and offsets of the non-throwing API
+TEST(CEFParserTest, TryParse)
+{
+    const std::vector<std::tuple<std::string, ParseErrorCode, size_t>> invalid_lines = {
+        {"", ParseErrorCode::EmptyLine, 0},
+        {"Not a CEF line", ParseErrorCode::MissingPrefix, 0},
+        {"CEF:0|Too|Few|Fields", ParseErrorCode::TooFewFields, 20},
+        {"CEF:0|Vendor||1.0|100|Event|1", ParseErrorCode::EmptyField, 13},
+        {"CEF:invalid|version|test|1.0|100|Event|1", ParseErrorCode::InvalidVersion, 4},
+        {"CEF:0|Vendor|Product|1.0|100|Event|high", ParseErrorCode::InvalidSeverity, 35}
+    };
+
+    for (const auto& [line, code, offset] : invalid_lines)
+    {
+        const auto result = Parser::tryParse(line);
+        ASSERT_FALSE(result.hasValue()) << line;
+        EXPECT_EQ(result.error().code, code) << line;
+        EXPECT_EQ(result.error().offset, offset) << line;
+        EXPECT_THROW(result.value(), ParseException);
+    }
+
+    const auto result = Parser::tryParse("CEF:0|Vendor|Product|1.0|100|Event|1|src=1.1.1.1");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->getSourceAddress(), "1.1.1.1");
+}
+
+// Test that lenient batch parsing skips and reports malformed lines
+TEST(CEFParserTest, LenientBatchParsing)
+{
+    const std::vector<std::string> lines = {
+        "CEF:0|Vendor1|Product1|1.0|100|Event1|1|src=1.1.1.1",
+        "<13>Jan 1 00:00:00 host banner",
+        "CEF:0|Vendor2|Product2|2.0|200|Event2|2|dst=2.2.2.2",
+        "CEF:0|Truncated"
+    };
+
+    std::vector<LineError> errors;
+    const auto events = Parser::parseMultiple(lines, errors);
+
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[1].getDeviceVendor(), "Vendor2");
+    ASSERT_EQ(errors.size(), 2);
+    EXPECT_EQ(errors[0].line_number, 2);
+    EXPECT_EQ(errors[0].error.code, ParseErrorCode::MissingPrefix);
+    EXPECT_EQ(errors[1].line_number, 4);
+    EXPECT_EQ(errors[1].error.code, ParseErrorCode::TooFewFields);
+
+    errors.clear();
+    const auto from_string = Parser::parseFromString(lines[0] + "\n" + lines[1], errors);
+    EXPECT_EQ(from_string.size(), 1);
+    EXPECT_EQ(errors.size(), 1);
+
+    EXPECT_THROW(Parser::parseMultiple(lines), ParseException);
+}
+
 // Test batch parsing of multiple CEF lines
 TEST(CEFParserTest, BatchParsing)
 {
@@ -155,3 +368,47 @@ TEST(CEFParserTest, ToStringReconstruction)
     EXPECT_EQ(reparsed.getName(), event.getName());
     EXPECT_EQ(reparsed.getSourceAddress(), event.getSourceAddress());
 }
+
+// Test that a projection keeps only the requested fields
+TEST(CEFParserTest, Projection)
+{
+    const std::string line = "CEF:0|Security|IDS|1.0|100|Test\\|Event|2|src=192.168.1.1 "
+                             "dst=10.0.0.1 rt=1700000000000 msg=x\\=y proto=TCP src=10.0.0.9";
+
+    ParseOptions options;
+    options.projection = std::make_shared<Projection>(
+        std::vector<std::string>{"sourceAddress", "rt", "dst", "src", "cs1"},
+        std::initializer_list<Projection::HeaderField>{Projection::HeaderField::Name});
+
+    const Event event = Parser::parse(line, options);
+    EXPECT_EQ(event.getVersion(), 0);
+    EXPECT_EQ(event.getSeverity(), Event::Severity::High);
+    EXPECT_EQ(event.getName(), "Test|Event");
+    EXPECT_EQ(event.getDeviceVendor(), "");
+    EXPECT_EQ(event.getDeviceEventClassId(), "");
+
+    // The last duplicate still wins, and typed accessors work on projected keys
+    ASSERT_EQ(event.getExtensions().size(), 3);
+    EXPECT_EQ(event.getSourceAddress(), "10.0.0.9");
+    EXPECT_EQ(event.getDestinationAddress(), "10.0.0.1");
+    EXPECT_TRUE(event.getTimestamp(ExtensionKey::DeviceReceiptTime).has_value());
+    EXPECT_FALSE(event.getMessage().has_value());
+    EXPECT_FALSE(event.getProtocol().has_value());
+
+    // Lazy extensions do not bring back the other keys
+    options.lazy_extensions = true;
+    EXPECT_EQ(Parser::parse(line, options).getExtensions().size(), 3);
+
+    // The filter sees fields outside the projection
+    options.filter = std::make_shared<Filter>("proto = TCP and deviceVendor = Security");
+    EXPECT_TRUE(Parser::tryParse(line, options));
+
+    const Projection all_headers({"msg"});
+    EXPECT_TRUE(all_headers.containsHeaderField(Projection::HeaderField::DeviceVendor));
+    EXPECT_EQ(all_headers.getExtensionKeys(), std::vector<std::string>{"msg"});
+
+    const auto extensions = Parser::parseExtensions("a=1 b=x\\=y c=3", &all_headers);
+    EXPECT_TRUE(extensions.empty());
+    const Projection keys({"a", "b"});
+    EXPECT_EQ(Parser::parseExtensions("a=1 b=x\\=y c=3", &keys).size(), 2);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "cef_stream_parser.hpp"
+
+#include <sstream>
+#include <unistd.h>
+
+using namespace cef_cpp;
+
+// Test lines straddling chunk boundaries, CRLF endings and blank lines
+TEST(CEFStreamParserTest, ChunkedLines)
+{
+    std::istringstream input(
+        "CEF:0|Vendor1|Product1|1.0|100|Event1|1|src=1.1.1.1 msg=first\r\n"
+        "\n"
+        "   \r\n"
+        "CEF:0|Vendor2|Product2|2.0|200|Event2|2|dst=2.2.2.2\n"
+        "CEF:0|Vendor3|Product3|3.0|300|Event3|3");
+
+    // A chunk size far below the line length forces lines to span several reads
+    StreamParser parser(input, {}, 8);
+    std::vector<Event> events;
+    for (const auto& event : parser) {
+        events.push_back(event);
+    }
+
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(events[0].getDeviceVendor(), "Vendor1");
+    EXPECT_EQ(events[0].getMessage(), "first");
+    EXPECT_EQ(events[1].getDestinationAddress(), "2.2.2.2");
+    EXPECT_EQ(events[2].getSeverity(), Event::Severity::VeryHigh);
+    EXPECT_EQ(parser.getLineNumber(), 5);
+    EXPECT_FALSE(parser.next().has_value());
+}
+
+// Test that errors report the physical line number and oversized lines are rejected
+TEST(CEFStreamParserTest, Errors)
+{
+    {
+        std::istringstream input("CEF:0|Vendor|Product|1.0|100|Event|1\n\nnot cef\n");
+        StreamParser parser(input);
+
+        EXPECT_TRUE(parser.next().has_value());
+        try {
+            parser.next();
+            FAIL() << "Expected ParseException";
+        } catch (const ParseException& e) {
+            EXPECT_EQ(std::string(e.what()).find("Error parsing line 3"), 0);
+        }
+    }
+
+    {
+        std::istringstream input("CEF:0|Vendor|Product|1.0|100|Event|1|msg=" +
+                                 std::string(100, 'x') + "\n");
+        StreamParser parser(input, {}, 16);
+        parser.setMaxLineLength(64);
+
+        EXPECT_THROW(parser.next(), ParseException);
+    }
+}
+
+// Test reading from a raw file descriptor
+TEST(CEFStreamParserTest, FileDescriptor)
+{
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    const std::string data = "CEF:0|Vendor|Product|1.0|100|Event|1|spt=80\n"
+                             "CEF:0|Vendor|Product|1.0|100|Event|2|spt=81\n";
+    ASSERT_EQ(write(fds[1], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    close(fds[1]);
+
+    StreamParser parser(fds[0], {}, 32);
+    std::vector<int> ports;
+    const size_t count = parser.forEach([&](Event&& event) {
+        ports.push_back(event.getSourcePort().value_or(0));
+    });
+    close(fds[0]);
+
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(ports, (std::vector<int>{80, 81}));
+}
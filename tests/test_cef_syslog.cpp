@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include "cef_parser.hpp"
+#include "cef_stream_parser.hpp"
+#include "cef_syslog.hpp"
+
+#include <sstream>
+
+using namespace cef_cpp;
+
+namespace {
+
+const std::string cef_payload =
+    "CEF:0|Security|threatmanager|1.0|100|worm successfully stopped|10|src=10.0.0.1";
+
+} // namespace
+
+// Test RFC 3164 headers with and without timestamp, hostname and tag
+TEST(CEFSyslogTest, Rfc3164)
+{
+    SyslogHeader header;
+    std::string_view payload;
+
+    const std::string padded = "<134>Nov  4 22:13:20 fw01 " + cef_payload;
+    ASSERT_TRUE(splitSyslogLine(padded, header, payload));
+    EXPECT_EQ(header.format, SyslogHeader::Format::Rfc3164);
+    EXPECT_EQ(header.priority, 134);
+    EXPECT_EQ(header.getFacility(), 16);
+    EXPECT_EQ(header.getSeverity(), 6);
+    EXPECT_EQ(header.timestamp, "Nov  4 22:13:20");
+    EXPECT_EQ(header.hostname, "fw01");
+    EXPECT_TRUE(header.app_name.empty());
+    EXPECT_EQ(payload, cef_payload);
+
+    const std::string tagged = "<13>Nov 14 2023 22:13:20 fw01 cefd[4711]: " + cef_payload;
+    ASSERT_TRUE(splitSyslogLine(tagged, header, payload));
+    EXPECT_EQ(header.timestamp, "Nov 14 2023 22:13:20");
+    EXPECT_EQ(header.hostname, "fw01");
+    EXPECT_EQ(header.app_name, "cefd");
+    EXPECT_EQ(payload, cef_payload);
+    EXPECT_EQ(payload.data(), tagged.data() + tagged.find("CEF:"));
+
+    const std::string iso = "<13>2023-11-14T22:13:20Z cefd: " + cef_payload;
+    ASSERT_TRUE(splitSyslogLine(iso, header, payload));
+    EXPECT_EQ(header.timestamp, "2023-11-14T22:13:20Z");
+    EXPECT_TRUE(header.hostname.empty());
+    EXPECT_EQ(header.app_name, "cefd");
+
+    const std::string bare = "fw01 " + cef_payload;
+    ASSERT_TRUE(splitSyslogLine(bare, header, payload));
+    EXPECT_EQ(header.priority, -1);
+    EXPECT_TRUE(header.timestamp.empty());
+    EXPECT_EQ(header.hostname, "fw01");
+
+    ASSERT_TRUE(splitSyslogLine(cef_payload, header, payload));
+    EXPECT_EQ(header.format, SyslogHeader::Format::None);
+
+    EXPECT_FALSE(splitSyslogLine("<134>Nov 14 22:13:20 fw01 no payload", header, payload));
+    EXPECT_FALSE(splitSyslogLine("<1340>Nov 14 22:13:20 fw01 " + cef_payload, header,
+                                 payload));
+}
+
+// Test RFC 5424 headers including structured data and a byte order mark
+TEST(CEFSyslogTest, Rfc5424)
+{
+    SyslogHeader header;
+    std::string_view payload;
+
+    const std::string full =
+        "<165>1 2023-11-14T22:13:20.123Z fw01.example.com cefd 4711 ID47 - " + cef_payload;
+    ASSERT_TRUE(splitSyslogLine(full, header, payload));
+    EXPECT_EQ(header.format, SyslogHeader::Format::Rfc5424);
+    EXPECT_EQ(header.priority, 165);
+    EXPECT_EQ(header.timestamp, "2023-11-14T22:13:20.123Z");
+    EXPECT_EQ(header.hostname, "fw01.example.com");
+    EXPECT_EQ(header.app_name, "cefd");
+    EXPECT_EQ(header.proc_id, "4711");
+    EXPECT_EQ(header.msg_id, "ID47");
+    EXPECT_TRUE(header.structured_data.empty());
+    EXPECT_EQ(payload, cef_payload);
+
+    const std::string structured =
+        "<165>1 - - - - - [origin ip=\"10.0.0.1\"][meta note=\"a \\] b\"] \xEF\xBB\xBF" +
+        cef_payload;
+    ASSERT_TRUE(splitSyslogLine(structured, header, payload));
+    EXPECT_TRUE(header.timestamp.empty());
+    EXPECT_TRUE(header.hostname.empty());
+    EXPECT_EQ(header.structured_data, "[origin ip=\"10.0.0.1\"][meta note=\"a \\] b\"]");
+    EXPECT_EQ(payload, cef_payload);
+
+    EXPECT_FALSE(splitSyslogLine("<165>1 - - - - - [unterminated " + cef_payload, header,
+                                 payload));
+    EXPECT_FALSE(splitSyslogLine("<165>1 - - - - - -", header, payload));
+}
+
+// Test that the parser strips syslog headers and keeps them as metadata
+TEST(CEFSyslogTest, ParseSyslog)
+{
+    const std::string line = "<134>Nov 14 22:13:20 fw01 cefd: " + cef_payload;
+    const auto view = Parser::tryParseSyslog(line);
+    ASSERT_TRUE(view.hasValue());
+    EXPECT_EQ(view->getSyslogHeader().hostname, "fw01");
+    EXPECT_EQ(view->getRawExtension("src"), "10.0.0.1");
+
+    const Event event = Parser::parse(line, {.syslog = true});
+    EXPECT_EQ(event.getDeviceVendor(), "Security");
+    EXPECT_EQ(event.getSyslogPriority(), 134);
+    EXPECT_EQ(event.getSyslogTimestamp(), "Nov 14 22:13:20");
+    EXPECT_EQ(event.getSyslogHostname(), "fw01");
+    EXPECT_EQ(event.getSyslogAppName(), "cefd");
+
+    // Plain CEF parses the same with or without the option
+    const Event plain = Parser::parse(cef_payload, {.syslog = true});
+    EXPECT_EQ(plain.getSyslogPriority(), -1);
+    EXPECT_TRUE(plain.getSyslogHostname().empty());
+
+    EXPECT_THROW(Parser::parse(line), ParseException);
+    EXPECT_EQ(Parser::tryParseSyslog("<134>Nov 14 22:13:20 fw01 garbage").error().code,
+              ParseErrorCode::InvalidSyslogHeader);
+
+    // Offsets of payload errors refer to the whole line
+    const std::string bad = "<134>Nov 14 22:13:20 fw01 CEF:x|V|P|1|1|N|1";
+    const auto error = Parser::tryParseSyslog(bad);
+    ASSERT_FALSE(error.hasValue());
+    EXPECT_EQ(error.error().code, ParseErrorCode::InvalidVersion);
+    EXPECT_EQ(error.error().offset, bad.find("CEF:") + 4);
+
+    std::vector<LineError> errors;
+    const auto events = Parser::parseFromString(line + "\n" + cef_payload + "\nbad\n", errors,
+                                                {.syslog = true});
+    EXPECT_EQ(events.size(), 2);
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0].line_number, 3);
+}
+
+// Test octet-counted and newline-terminated frames
+TEST(CEFSyslogTest, Framing)
+{
+    std::string_view frame;
+    size_t consumed = 0;
+
+    EXPECT_EQ(extractSyslogFrame("5 <1>hi3 <1>", false, frame, consumed),
+              FrameStatus::Complete);
+    EXPECT_EQ(frame, "<1>hi");
+    EXPECT_EQ(consumed, 7);
+
+    EXPECT_EQ(extractSyslogFrame("\r\n12 <1>hel", false, frame, consumed),
+              FrameStatus::Incomplete);
+    EXPECT_EQ(consumed, 2);
+    EXPECT_EQ(extractSyslogFrame("12 <1>hel", true, frame, consumed), FrameStatus::Invalid);
+    EXPECT_EQ(extractSyslogFrame("12", false, frame, consumed), FrameStatus::Incomplete);
+    EXPECT_EQ(extractSyslogFrame("12 ", false, frame, consumed), FrameStatus::Incomplete);
+
+    // Without a PRI after the length, digits start a newline-terminated frame
+    EXPECT_EQ(extractSyslogFrame("12 hel", true, frame, consumed), FrameStatus::Complete);
+    EXPECT_EQ(frame, "12 hel");
+    EXPECT_EQ(extractSyslogFrame("12x hello\n", false, frame, consumed),
+              FrameStatus::Complete);
+    EXPECT_EQ(frame, "12x hello");
+    EXPECT_EQ(extractSyslogFrame("12345678901 <1>x\n", false, frame, consumed),
+              FrameStatus::Complete);
+    EXPECT_EQ(frame, "12345678901 <1>x");
+    EXPECT_EQ(extractSyslogFrame("2024-01-01T00:00:00Z host CEF:0\n", false, frame,
+                                 consumed),
+              FrameStatus::Complete);
+    EXPECT_EQ(frame, "2024-01-01T00:00:00Z host CEF:0");
+
+    // Counted line breaks are not part of the message
+    EXPECT_EQ(extractSyslogFrame("6 <1>hi\n", false, frame, consumed), FrameStatus::Complete);
+    EXPECT_EQ(frame, "<1>hi");
+
+    EXPECT_EQ(extractSyslogFrame("<13>line\r\nnext", false, frame, consumed),
+              FrameStatus::Complete);
+    EXPECT_EQ(frame, "<13>line");
+    EXPECT_EQ(consumed, 10);
+    EXPECT_EQ(extractSyslogFrame("next", false, frame, consumed), FrameStatus::Incomplete);
+    EXPECT_EQ(extractSyslogFrame("next", true, frame, consumed), FrameStatus::Complete);
+    EXPECT_EQ(frame, "next");
+    EXPECT_EQ(extractSyslogFrame("\n\n", true, frame, consumed), FrameStatus::Incomplete);
+    EXPECT_EQ(consumed, 2);
+}
+
+// Test a TCP-style stream mixing octet-counted and newline-terminated frames
+TEST(CEFSyslogTest, StreamParser)
+{
+    const std::string first = "<134>1 2023-11-14T22:13:20Z fw01 cefd - - - " + cef_payload;
+    const std::string second = "<134>Nov 14 22:13:21 fw02 " + cef_payload + " msg=a\nb";
+    std::istringstream input(std::to_string(first.size()) + " " + first +
+                             std::to_string(second.size()) + " " + second +
+                             "<134>Nov 14 22:13:22 fw03 " + cef_payload + "\n");
+
+    StreamParser parser(input, {.syslog = true}, 16);
+    std::vector<Event> events;
+    for (const auto& event : parser) {
+        events.push_back(event);
+    }
+
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(events[0].getSyslogHostname(), "fw01");
+    EXPECT_EQ(events[0].getSyslogTimestamp(), "2023-11-14T22:13:20Z");
+    EXPECT_EQ(events[1].getSyslogHostname(), "fw02");
+    EXPECT_EQ(events[1].getMessage(), "a\nb");
+    EXPECT_EQ(events[2].getSyslogHostname(), "fw03");
+    EXPECT_EQ(parser.getLineNumber(), 3);
+
+    std::istringstream truncated("100 <134>Nov 14 22:13:22 fw03 CEF:0");
+    StreamParser truncated_parser(truncated, {.syslog = true});
+    EXPECT_THROW(truncated_parser.next(), ParseException);
+
+    // Lines without a PRI may start with a timestamp, whose digits are not a length
+    std::istringstream timestamp_first("2024-01-01T00:00:00Z fw04 " + cef_payload + "\n" +
+                                       std::to_string(first.size()) + " " + first);
+    StreamParser timestamp_parser(timestamp_first, {.syslog = true}, 16);
+    const auto headerless = timestamp_parser.next();
+    ASSERT_TRUE(headerless);
+    EXPECT_EQ(headerless->getSyslogHostname(), "fw04");
+    EXPECT_EQ(headerless->getSyslogTimestamp(), "2024-01-01T00:00:00Z");
+    const auto counted = timestamp_parser.next();
+    ASSERT_TRUE(counted);
+    EXPECT_EQ(counted->getSyslogHostname(), "fw01");
+    EXPECT_FALSE(timestamp_parser.next());
+}
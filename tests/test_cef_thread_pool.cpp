@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include "cef_parser.hpp"
+#include "cef_thread_pool.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace cef_cpp;
+
+// Test that every index is visited exactly once, including with stealing
+TEST(CEFThreadPoolTest, ParallelFor)
+{
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.getConcurrency(), 4);
+
+    std::vector<std::atomic<int>> visits(10007);
+    for (int round = 0; round < 3; ++round) {
+        pool.parallelFor(visits.size(), 7, [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                // Uneven chunk costs make the faster participants steal
+                if (i < 100) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+                ++visits[i];
+            }
+        });
+    }
+
+    for (const auto& count : visits) {
+        EXPECT_EQ(count, 3);
+    }
+
+    EXPECT_THROW(pool.parallelFor(100, 1, [](const size_t begin, size_t) {
+        if (begin == 42) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+
+    ThreadPool single(1);
+    size_t sum = 0;
+    single.parallelFor(10, 3, [&](const size_t begin, const size_t end) { sum += end - begin; });
+    EXPECT_EQ(sum, 10);
+}
+
+// Test that parallel batch parsing keeps input order and reports errors per line
+TEST(CEFThreadPoolTest, ParallelParseMultiple)
+{
+    std::vector<std::string> lines;
+    for (int i = 0; i < 5000; ++i) {
+        if (i % 1000 == 999) {
+            lines.emplace_back("truncated syslog line");
+        } else {
+            lines.push_back("CEF:0|Vendor|Product|1.0|100|Event|1|cnt=" + std::to_string(i) +
+                            (i % 7 == 0 ? " msg=" + std::string(2000, 'x') : ""));
+        }
+    }
+
+    ThreadPool pool(4);
+    std::vector<LineError> errors;
+    const auto events = Parser::parseMultiple(lines, errors, pool);
+
+    ASSERT_EQ(events.size(), 4995);
+    ASSERT_EQ(errors.size(), 5);
+    EXPECT_EQ(errors[0].line_number, 1000);
+    EXPECT_EQ(errors[4].line_number, 5000);
+    EXPECT_EQ(errors[0].error.code, ParseErrorCode::MissingPrefix);
+
+    size_t expected = 0;
+    for (const auto& event : events) {
+        if (expected % 1000 == 999) {
+            ++expected;
+        }
+        ASSERT_EQ(event.getExtension("cnt"), std::to_string(expected));
+        ++expected;
+    }
+
+    try {
+        Parser::parseMultiple(lines, pool);
+        FAIL() << "Expected ParseException";
+    } catch (const ParseException& e) {
+        EXPECT_EQ(std::string(e.what()).find("Error parsing line 1000"), 0);
+    }
+}
+
+// Test that a large multi-line string is parsed in order across chunks
+TEST(CEFThreadPoolTest, ParallelParseFromString)
+{
+    // Long enough to be parsed in parallel even without a pool
+    std::string log;
+    size_t lines = 0;
+    for (int i = 0; i < 20000; ++i) {
+        if (i % 5000 == 4999) {
+            log += "truncated syslog line\n";
+        } else {
+            log += "CEF:0|Vendor|Product|1.0|100|Event|1|cnt=" + std::to_string(i) +
+                   (i % 7 == 0 ? " msg=" + std::string(200, 'x') : "") +
+                   (i % 2 == 0 ? "\r\n" : "\n");
+        }
+        ++lines;
+        if (i % 3000 == 0) {
+            log += " \t\r\n\n";
+            lines += 2;
+        }
+    }
+    ASSERT_GE(log.size(), 1024 * 1024);
+
+    ThreadPool pool(4);
+    std::vector<LineError> errors;
+    const auto events = Parser::parseFromString(log, errors, pool);
+
+    ASSERT_EQ(events.size(), 19996);
+    ASSERT_EQ(errors.size(), 4);
+    // Blank lines count towards line numbers
+    EXPECT_EQ(errors[0].line_number, 5004);
+    EXPECT_EQ(errors[3].line_number, lines);
+    EXPECT_EQ(errors[0].error.code, ParseErrorCode::MissingPrefix);
+
+    size_t expected = 0;
+    for (const auto& event : events) {
+        if (expected % 5000 == 4999) {
+            ++expected;
+        }
+        ASSERT_EQ(event.getExtension("cnt"), std::to_string(expected));
+        ++expected;
+    }
+
+    std::vector<LineError> sequential_errors;
+    const auto sequential = Parser::parseFromString(log, sequential_errors);
+    ASSERT_EQ(sequential.size(), events.size());
+    EXPECT_EQ(sequential.back().toString(), events.back().toString());
+    ASSERT_EQ(sequential_errors.size(), errors.size());
+    EXPECT_EQ(sequential_errors[3].line_number, errors[3].line_number);
+
+    try {
+        Parser::parseFromString(log, pool);
+        FAIL() << "Expected ParseException";
+    } catch (const ParseException& e) {
+        EXPECT_EQ(std::string(e.what()).find("Error parsing line 5004"), 0);
+    }
+
+    // Calls without a pool share one and may run concurrently
+    std::vector<size_t> sizes(4);
+    {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < sizes.size(); ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<LineError> thread_errors;
+                sizes[t] = Parser::parseFromString(log, thread_errors).size();
+            });
+        }
+    }
+    EXPECT_EQ(sizes, std::vector<size_t>(4, events.size()));
+}